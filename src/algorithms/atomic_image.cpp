@@ -254,9 +254,9 @@ void wu_rekt(xy_d_t xy0, xy_d_t xy1,
     
     xy_d_t l = { u_ipart(min_x), u_ipart(min_y) };
     xy_d_t h = { u_ipart(max_x), u_ipart(max_y) };
-    // search the bounding box +/- 1 for pixels inside our bounds
-    for (double i = l.y-1; i < h.y+1; ++i) {
-        for (double j = l.x-1; j < h.x+1; ++j) {
+    // search the bounding box +/- 1 for pixels inside our bounds, clipped to the image
+    for (double i = std::max(0.0, l.y-1); i < std::min((double)image.height, h.y+1); ++i) {
+        for (double j = std::max(0.0, l.x-1); j < std::min((double)image.width, h.x+1); ++j) {
             // draw if it's in bounds
             if (inside({j, i})) {
                 image.set_pixel(j, i, color);
@@ -149,22 +149,30 @@ struct atomic_image_buf_t {
         }
         return bytes;
     }
+    // pixels outside of the buffer are clipped, as lines may cross the border of a tile
+    bool in_bounds(const double& x,
+                   const double& y) const {
+        return x >= 0 && y >= 0 && x < width && y < height;
+    }
     // ablative
-    void set_pixel(const uint64_t& x,
-                   const uint64_t& y,
+    void set_pixel(const double& x,
+                   const double& y,
                    const color_t& c) {
+        if (!in_bounds(x, y)) {
+            return; // bail out
+        }
         //size_t i = width * y + x;
         //std::cerr << "setting color with intensity " << f << std::endl;
-        (*image)[width * y + x] = c.hex;
+        (*image)[width * (uint64_t)y + (uint64_t)x] = c.hex;
     }
     // layering
-    void layer_pixel(const uint64_t& x,
-                     const uint64_t& y,
+    void layer_pixel(const double& x,
+                     const double& y,
                      const color_t& c) {
-        if (x >= width || y >= height) {
+        if (!in_bounds(x, y)) {
             return; // bail out
         }
-        size_t i = width * y + x;
+        size_t i = width * (uint64_t)y + (uint64_t)x;
         //std::cerr << "getting i=" << i << " " << y << " " << x << " " << " in image " << height << "x" << width << std::endl;
         color_t v;
         v.hex = (*image)[i].load();
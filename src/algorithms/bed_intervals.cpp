@@ -0,0 +1,96 @@
+#include "bed_intervals.hpp"
+#include <cstdlib>
+#include <omp.h>
+#include "hash_map.hpp"
+
+namespace odgi {
+
+namespace algorithms {
+
+void read_sorted_bed(std::istream& in,
+                     const uint64_t& min_fields,
+                     const std::string& caller,
+                     const std::function<bool(const std::string&)>& keep,
+                     std::vector<bed_sequence_t>& sequences,
+                     std::vector<std::string>* names) {
+    const int64_t skipped = -1;
+    // index of each sequence seen so far in sequences, or skipped
+    ska::flat_hash_map<std::string, int64_t> sequence_index;
+    std::vector<bool> unsorted(sequences.size(), false);
+    std::string current_name;
+    int64_t current = skipped;
+    bool first = true;
+
+    std::string line;
+    // the field boundaries, we only need the first four
+    size_t field_begin[4];
+    size_t field_end[4];
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#'
+            || line.compare(0, 5, "track") == 0 || line.compare(0, 7, "browser") == 0) {
+            continue;
+        }
+        uint64_t n_fields = 0;
+        size_t begin = 0;
+        while (n_fields < 4) {
+            const size_t tab = line.find('\t', begin);
+            field_begin[n_fields] = begin;
+            field_end[n_fields] = tab == std::string::npos ? line.size() : tab;
+            ++n_fields;
+            if (tab == std::string::npos) break;
+            begin = tab + 1;
+        }
+        if (n_fields < min_fields) {
+            std::cerr << "[odgi::" << caller << "] error: "
+                      << "BED line does not have enough fields to define an interval"
+                      << std::endl << line << std::endl;
+            exit(1);
+        }
+
+        // sorted input gives runs of the same sequence, so only a change of sequence needs a lookup
+        if (first || line.compare(field_begin[0], field_end[0] - field_begin[0], current_name) != 0) {
+            first = false;
+            current_name = line.substr(field_begin[0], field_end[0] - field_begin[0]);
+            auto f = sequence_index.find(current_name);
+            if (f != sequence_index.end()) {
+                current = f->second;
+            } else {
+                current = keep(current_name) ? (int64_t)sequences.size() : skipped;
+                if (current != skipped) {
+                    sequences.push_back({current_name, {}});
+                    unsorted.push_back(false);
+                }
+                sequence_index[current_name] = current;
+            }
+        }
+        if (current == skipped) {
+            continue;
+        }
+
+        bed_interval_t interval;
+        interval.start = n_fields > 1 ? std::strtoull(line.c_str() + field_begin[1], nullptr, 10) : 0;
+        interval.end = n_fields > 2 ? std::strtoull(line.c_str() + field_begin[2], nullptr, 10) : 0;
+        if (n_fields > 3) {
+            interval.name = line.substr(field_begin[3], field_end[3] - field_begin[3]);
+        }
+        auto& intervals = sequences[current].intervals;
+        if (!intervals.empty() && interval < intervals.back()) {
+            unsorted[current] = true;
+        }
+        if (names != nullptr) {
+            names->push_back(interval.name);
+        }
+        intervals.push_back(std::move(interval));
+    }
+
+#pragma omp parallel for schedule(dynamic,1)
+    for (uint64_t i = 0; i < sequences.size(); ++i) {
+        if (unsorted[i]) {
+            std::sort(sequences[i].intervals.begin(), sequences[i].intervals.end());
+        }
+    }
+}
+
+}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <tuple>
+#include <functional>
+#include <algorithm>
+#include <handlegraph/types.hpp>
+#include <handlegraph/path_handle_graph.hpp>
+
+/**
+ * \file bed_intervals.hpp
+ *
+ * A streaming engine for sorted BED records: records are read line by line and grouped by sequence, then matched
+ * against a path in a single forward walk along its steps. Each path is independent, so callers can process paths
+ * in parallel without sharing state.
+ */
+
+namespace odgi {
+
+namespace algorithms {
+
+using namespace handlegraph;
+
+/// One BED record: a half-open range [start, end) and its name (the 4th column, empty if missing).
+struct bed_interval_t {
+    uint64_t start;
+    uint64_t end;
+    std::string name;
+
+    bool operator<(const bed_interval_t& other) const {
+        return std::tie(start, end, name) < std::tie(other.start, other.end, other.name);
+    }
+};
+
+/// The records of one sequence, sorted by start, end and name.
+struct bed_sequence_t {
+    std::string name;
+    std::vector<bed_interval_t> intervals;
+};
+
+/// Read BED records line by line, grouping them by sequence in order of first appearance. Sorted input, as given by
+/// `sort -k1,1 -k2,2n`, is taken as is; only the sequences whose records arrive out of order are sorted afterwards.
+/// Empty lines and `#`, `track` and `browser` header lines are skipped, as are the records of sequences for which
+/// keep returns false. Exits with an error naming the caller if a record has fewer than min_fields fields.
+/// If names is given, the names of the kept records are appended to it in input order.
+void read_sorted_bed(std::istream& in,
+                     const uint64_t& min_fields,
+                     const std::string& caller,
+                     const std::function<bool(const std::string&)>& keep,
+                     std::vector<bed_sequence_t>& sequences,
+                     std::vector<std::string>* names = nullptr);
+
+/// Walk the path once, from its first to its last step, matching the intervals, which must be sorted by start.
+/// on_start(i, step, offset) is called on the step where interval i starts, and on_end(i, step, offset, clipped)
+/// on the step where it ends. Offsets are within the node as traversed by the path, so an interval ending at the end
+/// of a step has an end offset equal to the node length. Intervals starting beyond the path are not reported, those
+/// ending beyond it end on the last step with clipped set.
+template<typename OnStart, typename OnEnd>
+void sweep_path_intervals(const PathHandleGraph& graph,
+                          const path_handle_t& path,
+                          const std::vector<bed_interval_t>& intervals,
+                          OnStart&& on_start,
+                          OnEnd&& on_end) {
+    // the open intervals as (end, index), the first to end on top
+    typedef std::pair<uint64_t, uint64_t> open_t;
+    std::priority_queue<open_t, std::vector<open_t>, std::greater<open_t>> open;
+    uint64_t next = 0;
+    uint64_t pos = 0;
+    uint64_t last_length = 0;
+    step_handle_t last_step;
+    graph.for_each_step_in_path(path, [&](const step_handle_t& step) {
+        const uint64_t length = graph.get_length(graph.get_handle_of_step(step));
+        while (next < intervals.size() && intervals[next].start < pos + length) {
+            on_start(next, step, intervals[next].start - pos);
+            open.emplace(std::max(intervals[next].start, intervals[next].end), next);
+            ++next;
+        }
+        while (!open.empty() && open.top().first <= pos + length) {
+            on_end(open.top().second, step, open.top().first - pos, false);
+            open.pop();
+        }
+        pos += length;
+        last_length = length;
+        last_step = step;
+    });
+    while (!open.empty()) {
+        on_end(open.top().second, last_step, last_length, true);
+        open.pop();
+    }
+}
+
+}
+
+}
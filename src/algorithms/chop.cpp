@@ -62,6 +62,62 @@ namespace odgi {
             graph.apply_ordering(new_handles, true);
         }
 
+
+        void chop(graph_t &graph,
+                  const uint64_t &max_node_length, const uint64_t &nthreads, const bool &show_info) {
+            std::vector<handle_t> handles;
+            handles.reserve(graph.get_node_count());
+            graph.for_each_handle([&](const handle_t &handle) {
+                handles.push_back(handle);
+            });
+
+            std::vector<uint8_t> to_chop(handles.size(), 0);
+#pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+            for (uint64_t i = 0; i < handles.size(); ++i) {
+                to_chop[i] = graph.get_length(handles[i]) > max_node_length;
+            }
+            std::vector<std::pair<handle_t, std::vector<size_t>>> divisions;
+            std::vector<uint64_t> division_rank; // the original rank of each divided node
+            for (uint64_t i = 0; i < handles.size(); ++i) {
+                if (to_chop[i]) {
+                    divisions.push_back(std::make_pair(handles[i], std::vector<size_t>()));
+                    division_rank.push_back(i);
+                }
+            }
+
+            if (show_info) {
+                std::cerr << "[odgi::chop] " << divisions.size() << " node(s) to chop." << std::endl;
+            }
+
+            // get divide points
+#pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+            for (uint64_t i = 0; i < divisions.size(); ++i) {
+                const uint64_t length = graph.get_length(divisions[i].first);
+                auto& offsets = divisions[i].second;
+                for (uint64_t j = max_node_length; j < length; j += max_node_length) {
+                    offsets.push_back(j);
+                }
+            }
+
+            graph.set_number_of_threads(nthreads);
+            const std::vector<std::vector<handle_t>> parts = graph.divide_handles(divisions);
+
+            // the pieces take the place of their node in the order
+            std::vector<handle_t> new_handles;
+            new_handles.reserve(graph.get_node_count());
+            uint64_t d = 0;
+            for (uint64_t i = 0; i < handles.size(); ++i) {
+                if (d < division_rank.size() && division_rank[d] == i) {
+                    new_handles.insert(new_handles.end(), parts[d].begin(), parts[d].end());
+                    ++d;
+                } else {
+                    new_handles.push_back(handles[i]);
+                }
+            }
+
+            graph.apply_ordering(new_handles, true);
+        }
+
     }
 }
 
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "simple_components.hpp"
+#include "odgi.hpp"
 
 namespace odgi {
 namespace algorithms {
@@ -18,6 +19,12 @@ using namespace handlegraph;
  */
 void chop(handlegraph::MutablePathDeletableHandleGraph& graph, const uint64_t& max_node_length,
           const uint64_t& nthreads, const bool& show_info);
+
+/**
+ * Cut nodes to be less than the given max node length, dividing them all at once in parallel.
+ */
+void chop(graph_t& graph, const uint64_t& max_node_length,
+          const uint64_t& nthreads, const bool& show_info);
     
 }
 }
@@ -84,6 +84,57 @@ namespace odgi {
             return first;
         }
 
+        /*
+          Indexed min-heap over a node coverage array that stays sorted by node id. The heap holds
+          positions in the array, ordered by (coverage, id), so that the minimum coverage node is
+          at the top and find_first() keeps working on the array. Coverage only ever increases,
+          so after an update the node just has to be sifted down.
+        */
+        template<class NodeCoverage>
+        class NodeCoverageHeap {
+        public:
+            explicit NodeCoverageHeap(const std::vector<NodeCoverage> &array)
+                    : array(array), heap(array.size()), position(array.size()) {
+                for (size_t i = 0; i < heap.size(); ++i) {
+                    heap[i] = i;
+                    position[i] = i;
+                }
+                for (size_t i = heap.size() / 2; i-- > 0;) {
+                    sift_down(i);
+                }
+            }
+
+            /// Position in the array of the node with the lowest coverage.
+            size_t top() const { return heap.front(); }
+
+            /// Restore the heap after the coverage of array[i] has increased.
+            void increased(size_t i) { sift_down(position[i]); }
+
+        private:
+            const std::vector<NodeCoverage> &array;
+            std::vector<size_t> heap;     // heap slot -> array position
+            std::vector<size_t> position; // array position -> heap slot
+
+            bool less(size_t a, size_t b) const {
+                return array[a].second < array[b].second
+                       || (array[a].second == array[b].second && array[a].first < array[b].first);
+            }
+
+            void sift_down(size_t slot) {
+                while (true) {
+                    size_t smallest = slot;
+                    const size_t left = 2 * slot + 1, right = left + 1;
+                    if (left < heap.size() && less(heap[left], heap[smallest])) { smallest = left; }
+                    if (right < heap.size() && less(heap[right], heap[smallest])) { smallest = right; }
+                    if (smallest == slot) { return; }
+                    std::swap(heap[slot], heap[smallest]);
+                    position[heap[slot]] = slot;
+                    position[heap[smallest]] = smallest;
+                    slot = smallest;
+                }
+            }
+        };
+
         std::vector<handle_t>
         reverse_complement(const HandleGraph &graph, std::vector<handle_t> &forward) {
             std::vector<handle_t> result = forward;
@@ -277,21 +328,25 @@ namespace odgi {
             } else {
                 num_paths_per_component = max_number_of_paths_generable;
             }
+            // Keep the nodes sorted by id for the lookups while extending, and find the starting nodes through a heap.
+            ips4o::parallel::sort(all_nodes_depth.begin(), all_nodes_depth.end(),
+                      [](const node_coverage_t &a, const node_coverage_t &b) -> bool {
+                          return (a.first < b.first);
+                      }, nthreads);
+            NodeCoverageHeap<node_coverage_t> start_nodes(all_nodes_depth);
+
             // Generate num_paths_per_component paths in the component.
             uint64_t i;
             for (i = 0; i < num_paths_per_component; i++) {
-                // Choose a starting node with minimum coverage and then sort the nodes by id.
+                // Choose a starting node with minimum coverage.
                 std::deque<handle_t> path;
-                ips4o::parallel::sort(all_nodes_depth.begin(), all_nodes_depth.end(),
-                          [](const node_coverage_t &a, const node_coverage_t &b) -> bool {
-                              return (a.second < b.second);
-                          }, nthreads);
+                node_coverage_t &start = all_nodes_depth[start_nodes.top()];
 
 #ifdef debug_cover
-                std::cerr << node_coverage.front().first << " --- " << node_coverage.front().second << std::endl;
+                std::cerr << start.first << " --- " << start.second << std::endl;
 #endif
 
-                if (all_nodes_depth.front().second >= min_node_depth) {
+                if (start.second >= min_node_depth) {
                     if (show_progress) {
                         std::cerr << Coverage::name() << ": minimum node depth reached after generating " << i << " paths." << std::endl;
                     }
@@ -299,12 +354,8 @@ namespace odgi {
                     break;
                 }
 
-                path.push_back(graph.get_handle(all_nodes_depth.front().first, false));
-                Coverage::increase_coverage(all_nodes_depth.front());
-                ips4o::parallel::sort(all_nodes_depth.begin(), all_nodes_depth.end(),
-                          [](const node_coverage_t &a, const node_coverage_t &b) -> bool {
-                              return (a.first < b.first);
-                          }, nthreads);
+                path.push_back(graph.get_handle(start.first, false));
+                Coverage::increase_coverage(start);
 
                 // Extend the path forward if acyclic or in both directions otherwise.
                 bool success = true;
@@ -324,6 +375,14 @@ namespace odgi {
                     graph.append_step(new_path, handle);
                 }
 
+                // Only the nodes on the new path gained coverage.
+                for (handle_t handle : path) {
+                    const size_t first = find_first(all_nodes_depth, graph.get_id(handle));
+                    if (first < all_nodes_depth.size() && all_nodes_depth[first].first == graph.get_id(handle)) {
+                        start_nodes.increased(first);
+                    }
+                }
+
 #ifdef debug_cover
                 std::cerr << "Path_" + std::to_string(component_id) + "_" + std::to_string(i) << ":";
                 for (handle_t handle : path) {
@@ -358,7 +417,7 @@ namespace odgi {
                         bool write_node_depth, std::string &node_depth,
                         const uint64_t& nthreads, const bool& ignore_paths, const bool& show_progress) {
             std::vector<ska::flat_hash_set<handlegraph::nid_t>> weak_components = algorithms::weakly_connected_components(
-                    &graph);
+                    &graph, nthreads);
 
             // Handle each component separately.
             size_t processed_components = 0;
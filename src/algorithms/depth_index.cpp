@@ -0,0 +1,257 @@
+#include "depth_index.hpp"
+#include "progress.hpp"
+#include <algorithm>
+#include <memory>
+#include <omp.h>
+
+namespace odgi {
+namespace algorithms {
+
+depth_index_t::depth_index_t(const PathHandleGraph& graph,
+                             const std::vector<bool>& paths_to_consider,
+                             const uint64_t& nthreads,
+                             const bool progress) {
+    shift = graph.min_node_id();
+    if (graph.max_node_id() - shift >= graph.get_node_count()) {
+        std::cerr << "[odgi::algorithms::depth_index] error: the node IDs are not compacted. Please run 'odgi sort' using -O, --optimize to optimize the graph." << std::endl;
+        exit(1);
+    }
+    node_count = graph.get_node_count();
+    path_count = graph.get_path_count();
+    const bool subset_paths = !paths_to_consider.empty();
+
+    // node depths, written as full words so that threads never share one
+    node_depth = sdsl::int_vector<>(node_count, 0, 64);
+    node_depth_uniq = sdsl::int_vector<>(node_count, 0, 64);
+    std::unique_ptr<algorithms::progress_meter::ProgressMeter> node_progress_meter;
+    if (progress) {
+        node_progress_meter = std::make_unique<algorithms::progress_meter::ProgressMeter>(
+                node_count, "[odgi::algorithms::depth_index] Node Depth Progress:");
+    }
+    graph.for_each_handle(
+        [&](const handle_t& h) {
+            uint64_t depth = 0;
+            std::vector<uint64_t> paths_here;
+            graph.for_each_step_on_handle(
+                h,
+                [&](const step_handle_t& s) {
+                    const path_handle_t path = graph.get_path_handle_of_step(s);
+                    if (!subset_paths || paths_to_consider[as_integer(path)]) {
+                        ++depth;
+                        paths_here.push_back(as_integer(path));
+                    }
+                });
+            std::sort(paths_here.begin(), paths_here.end());
+            const uint64_t rank = graph.get_id(h) - shift;
+            node_depth[rank] = depth;
+            node_depth_uniq[rank] = std::unique(paths_here.begin(), paths_here.end()) - paths_here.begin();
+            if (progress) {
+                node_progress_meter->increment(1);
+            }
+        }, true);
+    if (progress) {
+        node_progress_meter->finish();
+    }
+
+    // lay out the steps of every path, in path handle order
+    std::vector<path_handle_t> paths;
+    uint64_t max_path_id = 0;
+    graph.for_each_path_handle([&](const path_handle_t& path) {
+        paths.push_back(path);
+        max_path_id = std::max(max_path_id, (uint64_t)as_integer(path));
+    });
+    std::vector<uint64_t> step_counts(max_path_id + 1, 0);
+#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+    for (uint64_t i = 0; i < paths.size(); ++i) {
+        step_counts[as_integer(paths[i])] = graph.get_step_count(paths[i]);
+    }
+    path_step_offset = sdsl::int_vector<>(max_path_id + 2, 0, 64);
+    for (uint64_t p = 0; p <= max_path_id; ++p) {
+        path_step_offset[p + 1] = path_step_offset[p] + step_counts[p];
+    }
+    const uint64_t total_steps = path_step_offset[max_path_id + 1];
+    step_end = sdsl::int_vector<>(total_steps, 0, 64);
+    step_rank = sdsl::int_vector<>(total_steps, 0, 64);
+    depth_prefix = sdsl::int_vector<64>(total_steps, 0);
+
+    std::unique_ptr<algorithms::progress_meter::ProgressMeter> path_progress_meter;
+    if (progress) {
+        path_progress_meter = std::make_unique<algorithms::progress_meter::ProgressMeter>(
+                paths.size(), "[odgi::algorithms::depth_index] Path Prefix Progress:");
+    }
+#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+    for (uint64_t i = 0; i < paths.size(); ++i) {
+        uint64_t idx = path_step_offset[as_integer(paths[i])];
+        uint64_t offset = 0;
+        uint64_t prefix = 0;
+        graph.for_each_step_in_path(
+            paths[i],
+            [&](const step_handle_t& step) {
+                const handle_t h = graph.get_handle_of_step(step);
+                const uint64_t rank = graph.get_id(h) - shift;
+                const uint64_t length = graph.get_length(h);
+                offset += length;
+                prefix += length * node_depth[rank];
+                step_end[idx] = offset;
+                step_rank[idx] = rank;
+                depth_prefix[idx] = prefix;
+                ++idx;
+            });
+        if (progress) {
+            path_progress_meter->increment(1);
+        }
+    }
+    if (progress) {
+        path_progress_meter->finish();
+    }
+
+    sdsl::util::bit_compress(node_depth);
+    sdsl::util::bit_compress(node_depth_uniq);
+    sdsl::util::bit_compress(path_step_offset);
+    sdsl::util::bit_compress(step_end);
+    sdsl::util::bit_compress(step_rank);
+}
+
+uint64_t depth_index_t::get_node_depth(const nid_t& id) const {
+    return node_depth[id - shift];
+}
+
+uint64_t depth_index_t::get_node_depth_uniq(const nid_t& id) const {
+    return node_depth_uniq[id - shift];
+}
+
+uint64_t depth_index_t::get_path_length(const path_handle_t& path) const {
+    const uint64_t begin = path_step_offset[as_integer(path)];
+    const uint64_t end = path_step_offset[as_integer(path) + 1];
+    return begin == end ? 0 : step_end[end - 1];
+}
+
+uint64_t depth_index_t::find_step(const uint64_t& begin, const uint64_t& end, const uint64_t& offset) const {
+    // first step whose end lies past the offset
+    uint64_t lo = begin, hi = end;
+    while (lo < hi) {
+        const uint64_t mid = lo + (hi - lo) / 2;
+        if (step_end[mid] <= offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+nid_t depth_index_t::get_node_at(const path_handle_t& path, const uint64_t& offset) const {
+    const uint64_t begin = path_step_offset[as_integer(path)];
+    const uint64_t end = path_step_offset[as_integer(path) + 1];
+    const uint64_t i = find_step(begin, end, offset);
+    return i == end ? 0 : step_rank[i] + shift;
+}
+
+uint64_t depth_index_t::get_depth_prefix(const path_handle_t& path, const uint64_t& offset) const {
+    const uint64_t begin = path_step_offset[as_integer(path)];
+    const uint64_t end = path_step_offset[as_integer(path) + 1];
+    const uint64_t i = find_step(begin, end, offset);
+    if (i == end) {
+        return begin == end ? 0 : depth_prefix[end - 1];
+    }
+    const uint64_t step_begin = (i == begin) ? 0 : step_end[i - 1];
+    const uint64_t prefix = (i == begin) ? 0 : depth_prefix[i - 1];
+    return prefix + (offset - step_begin) * node_depth[step_rank[i]];
+}
+
+double depth_index_t::get_mean_depth(const path_range_t& range) const {
+    const uint64_t path_length = get_path_length(range.begin.path);
+    const uint64_t begin = std::min(range.begin.offset, path_length);
+    const uint64_t end = std::min(range.end.offset, path_length);
+    // the range length is kept as requested, as done when walking the path
+    return (double)(get_depth_prefix(range.begin.path, end) - get_depth_prefix(range.begin.path, begin))
+        / (double)(range.end.offset - range.begin.offset);
+}
+
+bool depth_index_t::is_compatible(const PathHandleGraph& graph) const {
+    return graph.get_node_count() == node_count
+        && graph.min_node_id() == shift
+        && graph.get_path_count() == path_count;
+}
+
+void depth_index_t::save(const std::string& name) const {
+    std::ofstream dpidx_out(name);
+    serialize_members(dpidx_out);
+}
+
+void depth_index_t::load(const std::string& name) {
+    std::ifstream dpidx_in(name);
+    deserialize_members(dpidx_in);
+}
+
+void depth_index_t::serialize_members(std::ostream &out) const {
+    serialize_and_measure(out);
+}
+
+size_t depth_index_t::serialize_and_measure(std::ostream &out, sdsl::structure_tree_node *s, std::string name) const {
+
+    sdsl::structure_tree_node *child = sdsl::structure_tree::add_child(s, name, sdsl::util::class_name(*this));
+    size_t written = 0;
+
+    // Do the magic number
+    out << "DEPTHINDEX";
+    written += 10;
+
+    // GRAPH LAYOUT
+    written += sdsl::write_member(shift, out, child, "shift");
+    written += sdsl::write_member(node_count, out, child, "node_count");
+    written += sdsl::write_member(path_count, out, child, "path_count");
+    // NODE STUFF
+    written += node_depth.serialize(out, child, "node_depth");
+    written += node_depth_uniq.serialize(out, child, "node_depth_uniq");
+    // PATH STUFF
+    written += path_step_offset.serialize(out, child, "path_step_offset");
+    written += step_end.serialize(out, child, "step_end");
+    written += step_rank.serialize(out, child, "step_rank");
+    written += depth_prefix.serialize(out, child, "depth_prefix");
+
+    sdsl::structure_tree::add_size(child, written);
+    return written;
+}
+
+void depth_index_t::deserialize_members(std::istream &in) {
+    // simple alias to match an external interface
+    load_sdsl(in);
+}
+
+void depth_index_t::load_sdsl(std::istream &in) {
+
+    if (!in.good()) {
+        throw std::runtime_error("[odgi::algorithms::depth_index] error: SDSL depth index file does not exist or depth index stream cannot be read.");
+    }
+
+    char magic_buffer[10];
+    in.read(magic_buffer, 10);
+    if (std::string(magic_buffer, 10) != "DEPTHINDEX") {
+        throw std::runtime_error("[odgi::algorithms::depth_index] error: SDSL depth index file does not have 'DEPTHINDEX' as its magic value. The file must be malformed.");
+    }
+
+    try {
+        sdsl::read_member(shift, in);
+        sdsl::read_member(node_count, in);
+        sdsl::read_member(path_count, in);
+        node_depth.load(in);
+        node_depth_uniq.load(in);
+        path_step_offset.load(in);
+        step_end.load(in);
+        step_rank.load(in);
+        depth_prefix.load(in);
+    } catch (const std::runtime_error &e) {
+        throw e;
+    } catch (const std::bad_alloc &e) {
+        // We get std::bad_alloc generally if we try to read arbitrary data as an index.
+        std::cerr << "[odgi::algorithms::depth_index] error: SDSL depth index input data not in correct format. " << std::endl;
+        exit(1);
+    } catch (const std::exception &e) {
+        std::cerr << "[odgi::algorithms::depth_index] error: SDSL depth index file malformed." << std::endl;
+        throw e;
+    }
+}
+
+}
+}
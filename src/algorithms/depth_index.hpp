@@ -0,0 +1,84 @@
+#pragma once
+
+#include <sdsl/int_vector.hpp>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <handlegraph/types.hpp>
+#include <handlegraph/util.hpp>
+#include <handlegraph/path_handle_graph.hpp>
+#include "position.hpp"
+
+namespace odgi {
+
+namespace algorithms {
+
+using namespace handlegraph;
+
+/// A persistent depth index. It records the total and unique path depth of every node (by node rank, so the
+/// graph has to be optimized) and, for every path, the prefix sums of the base-weighted node depth at the end
+/// of each of its steps. The mean depth of any path range is then answered with two binary searches.
+struct depth_index_t {
+    depth_index_t() = default;
+    depth_index_t(const PathHandleGraph& graph,
+                  const std::vector<bool>& paths_to_consider,
+                  const uint64_t& nthreads,
+                  const bool progress);
+    // We cannot move, assign, or copy until we add code to point SDSL supports at the new addresses for their vectors.
+    depth_index_t(const depth_index_t& other) = delete;
+    depth_index_t(depth_index_t&& other) = delete;
+    depth_index_t& operator=(const depth_index_t& other) = delete;
+    depth_index_t& operator=(depth_index_t&& other) = delete;
+
+    /// depth of the node, counting only the paths considered at construction time
+    uint64_t get_node_depth(const nid_t& id) const;
+    /// number of distinct considered paths crossing the node
+    uint64_t get_node_depth_uniq(const nid_t& id) const;
+    /// length of the path in bp
+    uint64_t get_path_length(const path_handle_t& path) const;
+    /// the node under the given offset of the path, 0 if the offset lies outside of the path
+    nid_t get_node_at(const path_handle_t& path, const uint64_t& offset) const;
+    /// sum of the node depth over all bases of path in [0, offset)
+    uint64_t get_depth_prefix(const path_handle_t& path, const uint64_t& offset) const;
+    /// mean depth over the bases of the path range [begin, end)
+    double get_mean_depth(const path_range_t& range) const;
+    /// check that the index was built from a graph with the same node and path layout
+    bool is_compatible(const PathHandleGraph& graph) const;
+
+    void save(const std::string& name) const;
+    void load(const std::string& name);
+
+    uint64_t shift = 0;
+    uint64_t node_count = 0;
+    uint64_t path_count = 0;
+    // per node rank
+    sdsl::int_vector<> node_depth;
+    sdsl::int_vector<> node_depth_uniq;
+    // steps of path p are stored in [path_step_offset[p], path_step_offset[p+1]), p being the path handle's integer
+    sdsl::int_vector<> path_step_offset;
+    // per step, in path order
+    sdsl::int_vector<> step_end;
+    sdsl::int_vector<> step_rank;
+    sdsl::int_vector<64> depth_prefix;
+private:
+    /// index of the step in [begin, end) covering the offset, end if the offset lies beyond the path
+    uint64_t find_step(const uint64_t& begin, const uint64_t& end, const uint64_t& offset) const;
+
+    /// the magic number is DEPTHINDEX
+    size_t serialize_and_measure(std::ostream &out, sdsl::structure_tree_node *s = nullptr, std::string name = "") const;
+
+    /// Alias for serialize_and_measure().
+    void serialize_members(std::ostream &out) const;
+
+    /// Load the sdsl integer vectors of a depth index from a stream. Throw an Error if the stream
+    /// does not produce a valid depth index file.
+    void load_sdsl(std::istream &in);
+
+    /// Alias for load().
+    void deserialize_members(std::istream &in);
+};
+
+}
+
+}
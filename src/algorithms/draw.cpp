@@ -165,7 +165,9 @@ std::vector<uint8_t> rasterize(const std::vector<double> &X,
                                const double& line_width,
                                const double& path_line_spacing,
                                bool color_paths,
-                               std::vector<algorithms::color_t>& node_id_to_color) {
+                               std::vector<algorithms::color_t>& node_id_to_color,
+                               const uint64_t& nthreads,
+                               const uint64_t& supersample) {
 
     std::vector<std::vector<handle_t>> weak_components;
     coord_range_2d_t rendered_range;
@@ -195,36 +197,84 @@ std::vector<uint8_t> rasterize(const std::vector<double> &X,
     //std::cerr << "source " << source_width << "×" << source_height << std::endl;
     //std::cerr << "raster " << width << "×" << height << std::endl;
 
-    // an atomic image buffer that we can write into in parallel
-    atomic_image_buf_t image(width, height,
-                             source_width, source_height,
-                             source_min_x, source_min_y);
-
-    auto range_itr = component_ranges.begin();
-    for (auto& component : weak_components) {
-        auto& range = *range_itr++;
+    const uint64_t ss = std::max((uint64_t)1, supersample);
+    const double source_per_px_y = source_height / height;
+
+    // flatten the components, so that all nodes are projected into the image in one parallel pass
+    std::vector<handle_t> segment_handles;
+    std::vector<uint64_t> segment_components;
+    segment_handles.reserve(graph.get_node_count());
+    segment_components.reserve(graph.get_node_count());
+    for (uint64_t c = 0; c < weak_components.size(); ++c) {
+        for (auto& handle : weak_components[c]) {
+            segment_handles.push_back(handle);
+            segment_components.push_back(c);
+        }
+    }
+    const uint64_t n_segments = segment_handles.size();
+    std::vector<xy_d_t> segment_xy(2 * n_segments);
+    // how far a node's drawing may extend beyond its axis, in pixels
+    std::vector<double> segment_pad(n_segments);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (uint64_t i = 0; i < n_segments; ++i) {
+        auto& range = component_ranges[segment_components[i]];
         auto& x_off = range.x_offset;
         auto& y_off = range.y_offset;
-#pragma omp parallel for
-        for (uint64_t i = 0; i < component.size(); ++i) {
-            const handle_t& handle = component[i];
-            uint64_t a = 2 * number_bool_packing::unpack_number(handle);
-            xy_d_t xy0 = {
-                (X[a] * scale) - x_off,
-                (Y[a] * scale) + y_off
-            };
-            xy0.into(source_min_x, source_min_y,
-                     source_width, source_height,
-                     2, 2,
-                     width-4, height-4);
-            xy_d_t xy1 = {
-                (X[a + 1] * scale) - x_off,
-                (Y[a + 1] * scale) + y_off
-            };
-            xy1.into(source_min_x, source_min_y,
-                     source_width, source_height,
-                     2, 2,
-                     width-4, height-4);
+        uint64_t a = 2 * number_bool_packing::unpack_number(segment_handles[i]);
+        xy_d_t& xy0 = segment_xy[2 * i];
+        xy0 = {
+            (X[a] * scale) - x_off,
+            (Y[a] * scale) + y_off
+        };
+        xy0.into(source_min_x, source_min_y,
+                 source_width, source_height,
+                 2, 2,
+                 width-4, height-4);
+        xy_d_t& xy1 = segment_xy[2 * i + 1];
+        xy1 = {
+            (X[a + 1] * scale) - x_off,
+            (Y[a + 1] * scale) + y_off
+        };
+        xy1.into(source_min_x, source_min_y,
+                 source_width, source_height,
+                 2, 2,
+                 width-4, height-4);
+        const double steps = color_paths ? graph.get_step_count(segment_handles[i]) : 1;
+        segment_pad[i] = steps * (line_width + (color_paths ? path_line_spacing : 0)) / source_per_px_y + 2;
+    }
+    std::vector<uint64_t>().swap(segment_components);
+
+    // the image is drawn in horizontal bands, each rendered by one thread at ss times the resolution
+    // in its own buffer, and then averaged down into the image; a band is sized so that its buffer
+    // stays small whatever the image size
+    const uint64_t band_budget = 1 << 24;
+    const uint64_t band_height = std::max((uint64_t)1, std::min((uint64_t)256, band_budget / (4 * width * ss * ss)));
+    const uint64_t n_bands = (height + band_height - 1) / band_height;
+    std::vector<std::vector<uint64_t>> band_segments(n_bands);
+    for (uint64_t i = 0; i < n_segments; ++i) {
+        const double min_y = std::min(segment_xy[2 * i].y, segment_xy[2 * i + 1].y) - segment_pad[i];
+        const double max_y = std::max(segment_xy[2 * i].y, segment_xy[2 * i + 1].y) + segment_pad[i];
+        const uint64_t first = (uint64_t)std::max(0.0, min_y) / band_height;
+        const uint64_t last = std::min(n_bands - 1, (uint64_t)std::max(0.0, max_y) / band_height);
+        for (uint64_t b = first; b <= last; ++b) {
+            band_segments[b].push_back(i);
+        }
+    }
+    std::vector<double>().swap(segment_pad);
+
+    std::vector<uint8_t> bytes(4 * width * height);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+    for (uint64_t b = 0; b < n_bands; ++b) {
+        const uint64_t y_begin = b * band_height;
+        const uint64_t rows = std::min(band_height, height - y_begin);
+        atomic_image_buf_t image(width * ss, rows * ss,
+                                 source_width, source_per_px_y * rows,
+                                 source_min_x, source_min_y + source_per_px_y * y_begin);
+        for (auto& i : band_segments[b]) {
+            const handle_t& handle = segment_handles[i];
+            // into the coordinates of the band
+            xy_d_t xy0 = { segment_xy[2 * i].x * ss, (segment_xy[2 * i].y - y_begin) * ss };
+            xy_d_t xy1 = { segment_xy[2 * i + 1].x * ss, (segment_xy[2 * i + 1].y - y_begin) * ss };
             if (color_paths) {
                 std::vector<color_t> path_colors;
                 graph.for_each_step_on_handle(
@@ -248,11 +298,33 @@ std::vector<uint8_t> rasterize(const std::vector<double> &X,
                 wu_calc_wide_line(xy0, xy1, node_color, image, line_width);
             }
         }
+        std::vector<uint64_t>().swap(band_segments[b]);
+        // average each ss x ss block of samples into one pixel
+        for (uint64_t y = 0; y < rows; ++y) {
+            for (uint64_t x = 0; x < width; ++x) {
+                uint64_t r = 0, g = 0, bl = 0, al = 0;
+                for (uint64_t sy = y * ss; sy < (y + 1) * ss; ++sy) {
+                    for (uint64_t sx = x * ss; sx < (x + 1) * ss; ++sx) {
+                        color_t c = {(*image.image)[sy * image.width + sx].load()};
+                        r += c.c.r;
+                        g += c.c.g;
+                        bl += c.c.b;
+                        al += c.c.a;
+                    }
+                }
+                const uint64_t n = ss * ss;
+                const uint64_t j = 4 * ((y_begin + y) * width + x);
+                bytes[j    ] = (r + n / 2) / n;
+                bytes[j + 1] = (g + n / 2) / n;
+                bytes[j + 2] = (bl + n / 2) / n;
+                bytes[j + 3] = (al + n / 2) / n;
+            }
+        }
     }
 
     // todo, edges, paths, coverage, bins
     
-    return image.to_bytes();
+    return bytes;
 }
 
 void draw_png(const std::string& filename,
@@ -266,7 +338,9 @@ void draw_png(const std::string& filename,
               const double& line_width,
               const double& path_line_spacing,
               bool color_paths,
-              std::vector<algorithms::color_t>& node_id_to_color) {
+              std::vector<algorithms::color_t>& node_id_to_color,
+              const uint64_t& nthreads,
+              const uint64_t& supersample) {
     auto bytes = rasterize(X, Y,
                            graph,
                            scale,
@@ -276,7 +350,9 @@ void draw_png(const std::string& filename,
                            line_width,
                            path_line_spacing,
                            color_paths,
-                           node_id_to_color);
+                           node_id_to_color,
+                           nthreads,
+                           supersample);
     png::encodeOneStep(filename.c_str(), bytes, width, height);
 }
 
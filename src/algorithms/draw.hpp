@@ -71,6 +71,8 @@ void draw_svg(std::ostream &out,
               const double& scale,
               const double& border);
 
+/// Rasterize the layout into width x height RGBA bytes. The image is split into horizontal bands that are
+/// drawn by nthreads threads, each band in its own buffer with supersample x supersample samples per pixel.
 std::vector<uint8_t> rasterize(const std::vector<double> &X,
                                const std::vector<double> &Y,
                                const PathHandleGraph &graph,
@@ -81,7 +83,9 @@ std::vector<uint8_t> rasterize(const std::vector<double> &X,
                                const double& line_width,
                                const double& path_line_spacing,
                                bool color_paths,
-                               std::vector<algorithms::color_t>& node_id_to_color);
+                               std::vector<algorithms::color_t>& node_id_to_color,
+                               const uint64_t& nthreads = 1,
+                               const uint64_t& supersample = 1);
 
 void draw_png(const std::string& filename,
               const std::vector<double> &X,
@@ -94,7 +98,9 @@ void draw_png(const std::string& filename,
               const double& line_width,
               const double& path_line_spacing,
               bool color_paths,
-              std::vector<algorithms::color_t>& node_id_to_color);
+              std::vector<algorithms::color_t>& node_id_to_color,
+              const uint64_t& nthreads = 1,
+              const uint64_t& supersample = 1);
 
 
 
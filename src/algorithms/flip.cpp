@@ -13,11 +13,11 @@ void flip_paths(graph_t& graph,
         into.create_handle(graph.get_sequence(h), graph.get_id(h));
     });
     graph.for_each_handle([&](const handle_t& h) {
-        graph.follow_edges(h, false, [&](const handle_t& next) {
+        graph.follow_edges_fast(h, false, [&](const handle_t& next) {
             into.create_edge(into.get_handle(graph.get_id(h), graph.get_is_reverse(h)),
                              into.get_handle(graph.get_id(next), graph.get_is_reverse(next)));
         });
-        graph.follow_edges(h, true, [&](const handle_t& prev) {
+        graph.follow_edges_fast(h, true, [&](const handle_t& prev) {
             into.create_edge(into.get_handle(graph.get_id(prev), graph.get_is_reverse(prev)),
                              into.get_handle(graph.get_id(h), graph.get_is_reverse(h)));
         });
@@ -11,80 +11,80 @@ namespace odgi {
     namespace algorithms {
 
     std::vector<handle_t>groom(const handlegraph::MutablePathDeletableHandleGraph &graph,
-							   bool progress_reporting, const std::vector<handlegraph::path_handle_t> target_paths, bool use_bfs) {
+							   bool progress_reporting, const std::vector<handlegraph::path_handle_t> target_paths, bool use_bfs,
+							   const uint64_t &nthreads) {
 			bool target_grooming = (target_paths.size() > 0);
 
-            // This (s) is our set of oriented nodes.
-            //dyn::succinct_bitvector<dyn::spsi<dyn::packed_vector,256,16> > s;
-            uint64_t min_handle_rank = std::numeric_limits<uint64_t>::max();
             uint64_t max_handle_rank = 0;
             graph.for_each_handle(
                     [&](const handle_t &found) {
                         uint64_t handle_rank = number_bool_packing::unpack_number(found);
-                        min_handle_rank = std::min(min_handle_rank, handle_rank);
                         max_handle_rank = std::max(max_handle_rank, handle_rank);
                     });
 
-            // Start with the heads of the graph.
-            // We could also just use the first node of the graph.
-            std::vector<handle_t> seeds;
-			if (!target_grooming) {
-				bool use_heads = true;
-				bool use_tails = false;
-				if (use_heads) {
-					seeds = head_nodes(&graph);
-				} else if (use_tails) {
-					seeds = tail_nodes(&graph);
-				} else {
-					handle_t min_handle = number_bool_packing::pack(min_handle_rank, false);
-					seeds = {min_handle};
-				}
-			}
+            // The search never crosses from one weakly connected component to another,
+            // so each component is groomed on its own, in parallel.
+            uint64_t n_components = 0;
+            const std::vector<uint64_t> component_ids = weakly_connected_component_ids(graph, n_components, nthreads);
+            std::vector<nid_t> members;
+            std::vector<uint64_t> offsets;
+            weakly_connected_component_members(graph, component_ids, n_components, members, offsets);
+            const nid_t shift = graph.min_node_id();
 
 			// do we have target paths which we want to force to have a forward orientation?
 			std::vector<bool> is_ref;
 			std::vector<bool> needs_flipping;
+            std::vector<std::vector<handle_t>> component_seeds(n_components);
 			if (target_grooming) {
-				std::fill_n(std::back_inserter(is_ref), graph.get_node_count(), false);
-				std::fill_n(std::back_inserter(needs_flipping), graph.get_node_count(), false);
+				is_ref.resize(max_handle_rank + 1, false);
+				needs_flipping.resize(max_handle_rank + 1, false);
 				std::unique_ptr<progress_meter::ProgressMeter> target_paths_progress;
 				if (progress_reporting) {
 					std::string banner = "[odgi::groom] preparing target path vectors:";
 					target_paths_progress = std::make_unique<progress_meter::ProgressMeter>(target_paths.size(), banner);
 				}
-				for (handlegraph::path_handle_t target_path : target_paths) {
+				// walk the target paths in parallel
+				std::vector<std::vector<handle_t>> path_handles(target_paths.size());
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+				for (uint64_t p = 0; p < target_paths.size(); ++p) {
 					graph.for_each_step_in_path(
-							target_path,
+							target_paths[p],
 							[&](const step_handle_t& step) {
-								handle_t handle = graph.get_handle_of_step(step);
-								uint64_t i = number_bool_packing::unpack_number(handle);
-								if (!is_ref[i]) {
-									is_ref[i] = true;
-									seeds.push_back(handle);
-									// do we need flipping?
-									if (graph.get_is_reverse(handle)) {
-										needs_flipping[i] = true;
-									}
-								}
+								path_handles[p].push_back(graph.get_handle_of_step(step));
 							});
 					if (progress_reporting) {
 						target_paths_progress->increment(1);
 					}
 				}
+				// the first visit in the order of the target paths seeds a node and fixes its orientation
+				for (auto& handles : path_handles) {
+					for (auto& handle : handles) {
+						uint64_t i = number_bool_packing::unpack_number(handle);
+						if (!is_ref[i]) {
+							is_ref[i] = true;
+							component_seeds[component_ids[graph.get_id(handle) - shift]].push_back(handle);
+							// do we need flipping?
+							needs_flipping[i] = graph.get_is_reverse(handle);
+						}
+					}
+					std::vector<handle_t>().swap(handles);
+				}
 				if (progress_reporting) {
 					target_paths_progress->finish();
 				}
 			}
 
-            // We need to keep track of the nodes we haven't visited to seed subsequent runs of the BFS
-            dyn::succinct_bitvector<dyn::spsi<dyn::packed_vector, 256, 16> > unvisited, flipped;
-            for (uint64_t i = 0; i <= max_handle_rank; ++i) {
-                unvisited.push_back(1);
-                flipped.push_back(0);
-            }
+            // We need to keep track of the nodes we have visited to seed subsequent runs of the BFS
+            atomicbitvector::atomic_bv_t visited(max_handle_rank + 1);
+            atomicbitvector::atomic_bv_t flipped(max_handle_rank + 1);
 
-            uint64_t prev_max_root = 0;
-            uint64_t prev_max_length = 0;
+            // start with the largest components, so that they don't end up last on a thread
+            std::vector<uint64_t> component_order(n_components);
+            std::iota(component_order.begin(), component_order.end(), 0);
+            std::stable_sort(component_order.begin(), component_order.end(),
+                             [&](const uint64_t &a, const uint64_t &b) {
+                                 return offsets[a + 1] - offsets[a] > offsets[b + 1] - offsets[b];
+                             });
 
             std::unique_ptr<progress_meter::ProgressMeter> bfs_progress;
             if (progress_reporting) {
@@ -92,80 +92,76 @@ namespace odgi {
                 bfs_progress = std::make_unique<progress_meter::ProgressMeter>(graph.get_node_count(), banner);
             }
 
-            uint64_t edge_count = 0;
-
-            while (unvisited.rank1(unvisited.size()) != 0) {
-                if (use_bfs) {
-                    bfs(graph,
-                        [&graph, &unvisited, &flipped, &progress_reporting, &bfs_progress, &needs_flipping, &is_ref, &target_grooming]
-                        (const handle_t &h, const uint64_t &r, const uint64_t &l, const uint64_t &d) {
-                            if (progress_reporting) {
-                                bfs_progress->increment(1);
-                            }
-                            uint64_t i = number_bool_packing::unpack_number(h);
-                            unvisited.set(i, 0);
-							if (target_grooming && is_ref[i]) {
-								if (needs_flipping[i]) {
-									flipped.set(i, true);
-								} else {
-									flipped.set(i, false);
-								}
-							} else {
-								flipped.set(i, graph.get_is_reverse(h));
-							}
-                        },
-                        [&unvisited](const handle_t &h) {
-                            uint64_t i = number_bool_packing::unpack_number(h);
-                            return unvisited.at(i) == 0;
-                        },
-                        [&edge_count](const handle_t &l, const handle_t &h) {
-                            ++edge_count;
+            auto groom_handle = [&](const handle_t &h) {
+                if (progress_reporting) {
+                    bfs_progress->increment(1);
+                }
+                uint64_t i = number_bool_packing::unpack_number(h);
+                visited.set(i);
+                if (target_grooming && is_ref[i]) {
+                    flipped.set(i, needs_flipping[i]);
+                } else {
+                    flipped.set(i, graph.get_is_reverse(h));
+                }
+            };
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+            for (uint64_t k = 0; k < n_components; ++k) {
+                const uint64_t c = component_order[k];
+                // Start with the heads of the component, or with its target path nodes.
+                std::vector<handle_t> seeds;
+                if (target_grooming) {
+                    seeds.swap(component_seeds[c]);
+                } else {
+                    for (uint64_t m = offsets[c]; m < offsets[c + 1]; ++m) {
+                        const handle_t h = graph.get_handle(members[m]);
+                        bool no_left_edges = true;
+                        graph.follow_edges(h, true, [&](const handle_t &ignored) {
+                            no_left_edges = false;
                             return false;
-                        },
-                        [](void) { return false; },
-                        seeds,
-                        {},
-                        false); // don't use bidirectional search
-                    // get another seed
-                    if (unvisited.rank1(unvisited.size()) != 0) {
-                        uint64_t i = unvisited.select1(0);
-                        handle_t h = number_bool_packing::pack(i, false);
-                        seeds = {h};
+                        });
+                        if (no_left_edges) {
+                            seeds.push_back(h);
+                        }
                     }
-                } else {
-                    dfs(graph,
-                        [&graph, &unvisited, &flipped, &progress_reporting, &bfs_progress, &needs_flipping, &is_ref, &target_grooming]
-                        (const handle_t &h) {
-                            if (progress_reporting) {
-                                bfs_progress->increment(1);
-                            }
-                            uint64_t i = number_bool_packing::unpack_number(h);
-                            unvisited.set(i, 0);
-							if (target_grooming && is_ref[i]) {
-								if (needs_flipping[i]) {
-									flipped.set(i, true);
-								} else {
-									flipped.set(i, false);
-								}
-							} else {
-								flipped.set(i, graph.get_is_reverse(h));
-							}
-                        },
-                        [&unvisited](const handle_t &h) {
-                            uint64_t i = number_bool_packing::unpack_number(h);
-                            return unvisited.at(i) == 0;
-                        },
-                        [](const handle_t& h) { return false; },
-                        [](void) { return false; },
-                        seeds);
-                    //{},
-                    //false); // don't use bidirectional search
-                    // get another seed
-                    if (unvisited.rank1(unvisited.size()) != 0) {
-                        uint64_t i = unvisited.select1(0);
-                        handle_t h = number_bool_packing::pack(i, false);
-                        seeds = {h};
+                }
+
+                uint64_t next_member = offsets[c];
+                while (true) {
+                    // a component without heads or target path nodes has no seeds yet: dfs would then start
+                    // from every handle of the graph, so go straight to reseeding
+                    if (!seeds.empty()) {
+                        if (use_bfs) {
+                            bfs(graph,
+                                [&groom_handle](const handle_t &h, const uint64_t &r, const uint64_t &l, const uint64_t &d) {
+                                    groom_handle(h);
+                                },
+                                [&visited](const handle_t &h) {
+                                    return visited.test(number_bool_packing::unpack_number(h));
+                                },
+                                [](const handle_t &l, const handle_t &h) { return false; },
+                                [](void) { return false; },
+                                seeds,
+                                {},
+                                false); // don't use bidirectional search
+                        } else {
+                            dfs(graph,
+                                groom_handle,
+                                [](const handle_t &h) {},
+                                [](const handle_t &h) { return false; },
+                                [](void) { return false; },
+                                seeds);
+                        }
+                    }
+                    // get another seed, the first unvisited node of the component
+                    while (next_member < offsets[c + 1]
+                           && visited.test(number_bool_packing::unpack_number(graph.get_handle(members[next_member])))) {
+                        ++next_member;
+                    }
+                    if (next_member == offsets[c + 1]) {
+                        break;
                     }
+                    seeds = {graph.get_handle(members[next_member])};
                 }
             }
 
@@ -185,7 +181,7 @@ namespace odgi {
             graph.for_each_handle(
                     [&graph, &order, &flipped, &num_flipped_handles, &progress_reporting, &handle_progress](
                             const handle_t &h) {
-                        bool to_flip = flipped[number_bool_packing::unpack_number(h)];
+                        bool to_flip = flipped.test(number_bool_packing::unpack_number(h));
                         if (!to_flip) {
                             order.push_back(h);
                         } else {
@@ -5,11 +5,17 @@
 #include <handlegraph/mutable_path_deletable_handle_graph.hpp>
 
 #include <vector>
+#include <numeric>
+#include <algorithm>
+#include <omp.h>
 
 #include "dynamic.hpp"
+#include "atomic_bitvector.hpp"
 #include "topological_sort.hpp"
 #include "progress.hpp"
 #include "dfs.hpp"
+#include "bfs.hpp"
+#include "weakly_connected_components.hpp"
 
 namespace odgi {
     namespace algorithms {
@@ -17,13 +23,16 @@ namespace odgi {
         using namespace handlegraph;
 
 /**
- * Remove spurious inverting links based on a dominant orientation of the graph
+ * Remove spurious inverting links based on a dominant orientation of the graph.
+ * Weakly connected components are groomed independently on nthreads threads,
+ * each from its heads, or from its target path nodes if target paths are given.
  */
         std::vector<handle_t>
         groom(const handlegraph::MutablePathDeletableHandleGraph &graph,
               bool progress_reporting,
 			  const std::vector<handlegraph::path_handle_t> target_paths,
-              bool use_bfs = true);
+              bool use_bfs = true,
+              const uint64_t &nthreads = 1);
 
     }
 }
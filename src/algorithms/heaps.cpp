@@ -9,7 +9,8 @@ void for_each_heap_permutation(const PathHandleGraph& graph,
                                const ska::flat_hash_map<path_handle_t, std::vector<interval_t>>& path_intervals,
                                uint64_t n_permutations,
                                uint64_t min_node_depth,
-                               const std::function<void(const std::vector<uint64_t>&, uint64_t)>& func) {
+                               const std::function<void(const std::vector<uint64_t>&, uint64_t)>& func,
+                               bool bit_parallel) {
     //const std::function<bool(const path_handle_t&, _t)>& in_range) {
     //std::vector<std::vector<path_handle_t>>
     auto get_permutation = [&](void) {
@@ -86,6 +87,62 @@ void for_each_heap_permutation(const PathHandleGraph& graph,
         }
     }
 
+    if (bit_parallel) {
+        // give each target node a column, weighted by its length
+        std::vector<uint64_t> column_lengths;
+        std::vector<uint64_t> rank_to_column(graph.get_node_count(), std::numeric_limits<uint64_t>::max());
+        for (uint64_t rank = 0; rank < graph.get_node_count(); ++rank) {
+            if (target_nodes[rank]) {
+                rank_to_column[rank] = column_lengths.size();
+                column_lengths.push_back(graph.get_length(graph.get_handle(rank + 1)));
+            }
+        }
+        const uint64_t words_per_group = (column_lengths.size() + 63) / 64;
+        // one row of node bits per group
+        std::vector<uint64_t> group_bits(path_groups.size() * words_per_group, 0);
+#pragma omp parallel for schedule(dynamic,1)
+        for (uint64_t j = 0; j < path_groups.size(); ++j) {
+            uint64_t* bits = &group_bits[j * words_per_group];
+            for (auto& path : path_groups[j]) {
+                graph.for_each_step_in_path(
+                    path,
+                    [&](const step_handle_t& step) {
+                        uint64_t column = rank_to_column[graph.get_id(graph.get_handle_of_step(step))-1]; // assumes compaction!
+                        if (column != std::numeric_limits<uint64_t>::max()) {
+                            bits[column >> 6] |= 1ULL << (column & 63);
+                        }
+                    });
+            }
+        }
+
+#pragma omp parallel for schedule(dynamic,1)
+        for (uint64_t i = 0; i < n_permutations; ++i) {
+            auto permutation = get_permutation();
+            std::vector<uint64_t> seen(words_per_group, 0);
+            uint64_t seen_bp = 0;
+            std::vector<uint64_t> vals;
+            vals.reserve(permutation.size());
+            for (auto& j : permutation) {
+                const uint64_t* bits = &group_bits[j * words_per_group];
+                for (uint64_t w = 0; w < words_per_group; ++w) {
+                    uint64_t fresh = bits[w] & ~seen[w];
+                    if (fresh) {
+                        seen[w] |= fresh;
+                        // every node is newly covered at most once per permutation
+                        const uint64_t* lengths = &column_lengths[w << 6];
+                        do {
+                            seen_bp += lengths[__builtin_ctzll(fresh)];
+                            fresh &= fresh - 1;
+                        } while (fresh);
+                    }
+                }
+                vals.push_back(seen_bp);
+            }
+            func(vals, i);
+        }
+        return;
+    }
+
 #pragma omp parallel for
     for (uint64_t i = 0; i < n_permutations; ++i) {
         auto permutation = get_permutation();
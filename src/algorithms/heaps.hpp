@@ -6,6 +6,7 @@
 #include <set>
 #include <algorithm>
 #include <random>
+#include <limits>
 #include <omp.h>
 #include "hash_map.hpp"
 #include "position.hpp"
@@ -24,12 +25,15 @@ namespace algorithms {
 
 /// For each permutation of the path groups
 /// we call func with a vector that is the fraction of the pangenome covered when we've considered N groups in the permutation
+/// With bit_parallel, we first record which target nodes each group covers in a group x node bitmatrix,
+/// and each permutation only ORs the groups' bit rows together, adding the lengths of the newly covered nodes
 void for_each_heap_permutation(const PathHandleGraph& graph,
                                const std::vector<std::vector<path_handle_t>>& path_groups,
                                const ska::flat_hash_map<path_handle_t, std::vector<interval_t>>& path_intervals,
                                uint64_t n_permutations,
                                uint64_t min_node_depth,
-                               const std::function<void(const std::vector<uint64_t>&, uint64_t)>& func);
+                               const std::function<void(const std::vector<uint64_t>&, uint64_t)>& func,
+                               bool bit_parallel = false);
 
 }
 
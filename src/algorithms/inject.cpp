@@ -7,136 +7,82 @@ namespace algorithms {
 using namespace handlegraph;
 
 void inject_ranges(MutablePathDeletableHandleGraph& graph,
-                   const ska::flat_hash_map<path_handle_t, std::vector<std::pair<interval_t, std::string>>>& path_intervals,
+                   const std::vector<path_handle_t>& paths,
+                   const std::vector<std::vector<bed_interval_t>>& path_intervals,
                    const std::vector<std::string>& ordered_intervals, const bool show_progress) {
 
-    // we collect cut points based on where our intervals start and end
-    ska::flat_hash_map<handle_t, std::vector<size_t>> cut_points;
-
-    // parallel over paths requires collecting path handles in a vector
-    std::vector<path_handle_t> paths;
-    graph.for_each_path_handle([&](const path_handle_t& path) {
-        paths.push_back(path);
-    });
-
-    std::atomic<uint64_t> num_intervals;
-    num_intervals.store(0);
+    uint64_t num_intervals = 0;
+    for (auto& intervals : path_intervals) {
+        num_intervals += intervals.size();
+    }
 
     std::unique_ptr<algorithms::progress_meter::ProgressMeter> progress;
     if (show_progress) {
-        // Count intervals to process
-#pragma omp parallel for
-        for (auto& path : paths) {
-            auto x = path_intervals.find(path);
-            if (x != path_intervals.end()) {
-                num_intervals += x->second.size();
-            }
-        }
-
         progress = std::make_unique<algorithms::progress_meter::ProgressMeter>(
-                num_intervals.load(), "[odgi::inject] collecting cut points");
+                num_intervals, "[odgi::inject] collecting cut points");
     }
 
-#pragma omp parallel for
-    for (auto& path : paths) {
-        if (path_intervals.find(path) != path_intervals.end()) {
-            auto& intervals = path_intervals.find(path)->second;
-            auto ival = intervals.begin();
-            std::set<uint64_t> interval_ends;
-            uint64_t pos = 0;
-            handle_t last_h;
-            graph.for_each_step_in_path(
-                path,
-                [&](const step_handle_t& step) {
-                    // remove intervals that ended before this node
-                    while (interval_ends.size()
-                           && *interval_ends.begin() <= pos) {
-                        auto last_length = graph.get_length(last_h);
-                        auto last_offset =
-                            graph.get_is_reverse(last_h) ?
-                            (pos - *interval_ends.begin())
-                            : last_length - (pos - *interval_ends.begin());
-                        if (last_offset > 0 && last_offset < last_length) {
-                            // store cut points on the forward strand to avoid dups
-                            auto last_h_fwd = graph.get_is_reverse(last_h) ?
-                                graph.flip(last_h) : last_h;
-#pragma omp critical (cut_points)
-                            cut_points[last_h_fwd].push_back(last_offset);
-                        }
-                        interval_ends.erase(interval_ends.begin());
-                    }
-                    auto h = graph.get_handle_of_step(step);
-                    auto len = graph.get_length(h);
-                    // add intervals that start on this node
-                    while (ival != intervals.end()
-                           && ival->first.first >= pos
-                           && ival->first.first < pos + len) {
-                        interval_ends.insert(ival->first.second);
-                        // mark a cut point
-                        auto offset = graph.get_is_reverse(h) ?
-                            len - (ival->first.first - pos)
-                            : ival->first.first - pos;
-                        if (offset > 0 && offset < len) {
-                            // store cut points on the forward strand to avoid dups
-                            auto h_fwd = graph.get_is_reverse(h) ?
-                                graph.flip(h) : h;
-#pragma omp critical (cut_points)
-                            cut_points[h_fwd].push_back(offset);
-                        }
-                        ++ival;
-                        if (show_progress) {
-                            progress->increment(1);
-                        }
-                    }
-                    pos += len;
-                    last_h = h;
-                });
-
-            // Manage last offsets
-            while (interval_ends.size() && *interval_ends.begin() <= pos) {
-                auto last_length = graph.get_length(last_h);
-                auto last_offset =
-                        graph.get_is_reverse(last_h) ?
-                        (pos - *interval_ends.begin())
-                                                     : last_length - (pos - *interval_ends.begin());
-                if (last_offset > 0 && last_offset < last_length) {
-                    // store cut points on the forward strand to avoid dups
-                    auto last_h_fwd = graph.get_is_reverse(last_h) ?
-                                      graph.flip(last_h) : last_h;
-#pragma omp critical (cut_points)
-                    cut_points[last_h_fwd].push_back(last_offset);
+    // we collect cut points based on where our intervals start and end
+    // each path collects its own, on the forward strand to avoid dups, so threads share nothing
+    std::vector<std::vector<std::pair<handle_t, uint64_t>>> path_cut_points(paths.size());
+#pragma omp parallel for schedule(dynamic,1)
+    for (uint64_t i = 0; i < paths.size(); ++i) {
+        auto& cuts = path_cut_points[i];
+        auto add_cut = [&](const step_handle_t& step, const uint64_t& offset) {
+            const handle_t h = graph.get_handle_of_step(step);
+            const uint64_t len = graph.get_length(h);
+            if (offset > 0 && offset < len) {
+                if (graph.get_is_reverse(h)) {
+                    cuts.push_back(std::make_pair(graph.flip(h), len - offset));
+                } else {
+                    cuts.push_back(std::make_pair(h, offset));
                 }
-                interval_ends.erase(interval_ends.begin());
             }
-        }
+        };
+        sweep_path_intervals(
+            graph, paths[i], path_intervals[i],
+            [&](const uint64_t& j, const step_handle_t& step, const uint64_t& offset) {
+                add_cut(step, offset);
+                if (show_progress) {
+                    progress->increment(1);
+                }
+            },
+            [&](const uint64_t& j, const step_handle_t& step, const uint64_t& offset, const bool& clipped) {
+                if (!clipped) {
+                    add_cut(step, offset);
+                }
+            });
     }
 
     if (show_progress) {
         progress->finish();
     }
 
+    ska::flat_hash_map<handle_t, std::vector<size_t>> cut_points;
+    for (auto& cuts : path_cut_points) {
+        for (auto& c : cuts) {
+            cut_points[c.first].push_back(c.second);
+        }
+        std::vector<std::pair<handle_t, uint64_t>>().swap(cuts);
+    }
+    std::vector<std::vector<size_t>*> cut_offsets;
+    cut_offsets.reserve(cut_points.size());
     for (auto& c : cut_points) {
-        auto& v = c.second;
+        cut_offsets.push_back(&c.second);
+    }
+#pragma omp parallel for schedule(dynamic,1)
+    for (uint64_t i = 0; i < cut_offsets.size(); ++i) {
+        auto& v = *cut_offsets[i];
         std::sort(v.begin(), v.end());
         v.erase(std::unique(v.begin(), v.end()), v.end());
     }
 
-    /*
-    for (auto& c : cut_points) {
-        std::cerr << "cutting at " << graph.get_id(c.first) << " -> ";
-        for (auto& p : c.second) {
-            std::cerr << p << " ";
-        }
-        std::cerr << std::endl;
-    }
-    */
-
     // then we cut the nodes in the graph at the interval starts and ends
     chop_at(graph, cut_points);
 
     if (show_progress) {
         progress = std::make_unique<algorithms::progress_meter::ProgressMeter>(
-                num_intervals.load(), "[odgi::inject] injecting intervals");
+                num_intervals, "[odgi::inject] injecting intervals");
     }
 
     ska::flat_hash_map<std::string, path_handle_t> injected_paths;
@@ -153,95 +99,46 @@ void inject_ranges(MutablePathDeletableHandleGraph& graph,
     }
 
     // then we iterate back through the sorted path intervals and add paths at the appropriate points
-#pragma omp parallel for
-    for (auto& path : paths) {
-        if (path_intervals.find(path) != path_intervals.end()) {
-            auto& intervals = path_intervals.find(path)->second;
-            auto ival = intervals.begin();
-            // IMPORTANT: in the key of the map, the end position (uint64_t) has
-            // to come first to keep the open intervals sorted by end coordinates.
-            // The annotation name (std::string) is necessary to avoid losing
-            // annotations having the same end coordinates.
-            std::map<std::pair<uint64_t, std::string>, step_handle_t> open_intervals_by_end;
-            uint64_t pos = 0;
-            handle_t last_h;
-            graph.for_each_step_in_path(
-                path,
-                [&](const step_handle_t& step) {
-                    // remove intervals that ended before this node
-                    while (open_intervals_by_end.size()
-                           && open_intervals_by_end.begin()->first.first <= pos) {
-                        // get reference to name
-                        auto& name = open_intervals_by_end.begin()->first.second;
-                        if (open_intervals_by_end.begin()->first.first != pos) {
-                            std::cerr << "[odgi::algorithms::inject_ranges] "
-                                      << "injection end point for interval " << name
-                                      << " is not at a node boundary: "
-                                      << "off by " << open_intervals_by_end.begin()->first.first
-                                      << " vs " << pos
-                                      << " on a node "
-                                      << graph.get_length(graph.get_handle_of_step(step))
-                                      << "bp long"
-                                      << std::endl;
-                            exit(1);
-                        }
-                        // add the path
-                        path_handle_t p;
-#pragma omp critical (get_path)
-                        {
-                            auto f = injected_paths.find(name);
-                            assert(f != injected_paths.end());
-                            p = f->second;
-                        }
-                        auto& c = open_intervals_by_end.begin()->second;
-                        auto end = step;
-                        do {
-                            graph.append_step(p, graph.get_handle_of_step(c));
-                            c = graph.get_next_step(c);
-                        } while (c != end);
-                        // clean up
-                        open_intervals_by_end.erase(open_intervals_by_end.begin());
-                    }
-                    auto h = graph.get_handle_of_step(step);
-                    auto len = graph.get_length(h);
-                    // add intervals that start on this node
-                    while (ival != intervals.end()
-                           && ival->first.first >= pos
-                           && ival->first.first < pos + len) {
-                        // the intervals must start at the node start
-                        open_intervals_by_end[std::make_pair(ival->first.second, ival->second)] = step;
-                        ++ival;
-                        if (show_progress) {
-                            progress->increment(1);
-                        }
-                    }
-                    pos += len;
-                    last_h = h;
-                });
-
-            // Add last paths
-            while (open_intervals_by_end.size()
-                   && open_intervals_by_end.begin()->first.first <= pos) {
-                // get reference to name
-                auto& name = open_intervals_by_end.begin()->first.second;
-                // add the path
-                path_handle_t p;
-#pragma omp critical (get_path)
-                {
-                    auto f = injected_paths.find(name);
-                    assert(f != injected_paths.end());
-                    p = f->second;
+    // after the cut, every interval starts at the start of a step and ends at the end of one
+#pragma omp parallel for schedule(dynamic,1)
+    for (uint64_t i = 0; i < paths.size(); ++i) {
+        auto& intervals = path_intervals[i];
+        std::vector<step_handle_t> first_steps(intervals.size());
+        sweep_path_intervals(
+            graph, paths[i], intervals,
+            [&](const uint64_t& j, const step_handle_t& step, const uint64_t& offset) {
+                first_steps[j] = step;
+                if (show_progress) {
+                    progress->increment(1);
+                }
+            },
+            [&](const uint64_t& j, const step_handle_t& step, const uint64_t& offset, const bool& clipped) {
+                if (clipped) {
+                    // the interval runs past the end of the path
+                    return;
                 }
-                auto& c = open_intervals_by_end.begin()->second;
-                auto end = graph.path_end(path);
+                const uint64_t len = graph.get_length(graph.get_handle_of_step(step));
+                if (offset != len) {
+                    std::cerr << "[odgi::algorithms::inject_ranges] "
+                              << "injection end point for interval " << intervals[j].name
+                              << " is not at a node boundary: "
+                              << "off by " << len - offset
+                              << " on a node "
+                              << len
+                              << "bp long"
+                              << std::endl;
+                    exit(1);
+                }
+                auto f = injected_paths.find(intervals[j].name);
+                assert(f != injected_paths.end());
+                const path_handle_t p = f->second;
+                const step_handle_t end = graph.get_next_step(step);
+                step_handle_t c = first_steps[j];
                 do {
                     graph.append_step(p, graph.get_handle_of_step(c));
                     c = graph.get_next_step(c);
                 } while (c != end);
-                // clean up
-                open_intervals_by_end.erase(open_intervals_by_end.begin());
-            }
-        }
+            });
     }
 
     if (show_progress) {
@@ -249,6 +146,22 @@ void inject_ranges(MutablePathDeletableHandleGraph& graph,
     }
 }
 
+void inject_ranges(MutablePathDeletableHandleGraph& graph,
+                   const ska::flat_hash_map<path_handle_t, std::vector<std::pair<interval_t, std::string>>>& path_intervals,
+                   const std::vector<std::string>& ordered_intervals, const bool show_progress) {
+    std::vector<path_handle_t> paths;
+    std::vector<std::vector<bed_interval_t>> intervals;
+    for (auto& p : path_intervals) {
+        paths.push_back(p.first);
+        intervals.emplace_back();
+        for (auto& i : p.second) {
+            intervals.back().push_back({i.first.first, i.first.second, i.second});
+        }
+        std::sort(intervals.back().begin(), intervals.back().end());
+    }
+    inject_ranges(graph, paths, intervals, ordered_intervals, show_progress);
+}
+
 void chop_at(MutablePathDeletableHandleGraph &graph,
              const ska::flat_hash_map<handle_t, std::vector<size_t>>& cut_points) {
 
@@ -10,6 +10,7 @@
 #include "hash_map.hpp"
 #include "progress.hpp"
 #include "position.hpp"
+#include "bed_intervals.hpp"
 #include <handlegraph/types.hpp>
 #include <handlegraph/iteratee.hpp>
 #include <handlegraph/util.hpp>
@@ -25,6 +26,13 @@ using namespace handlegraph;
 
 /// Modify the graph to include the named intervals as paths
 /// This will cut nodes at interval start/ends and then embed them in the graph
+/// path_intervals[i] are the intervals of paths[i], sorted by start; ordered_intervals are their names in input order
+void inject_ranges(MutablePathDeletableHandleGraph& graph,
+                   const std::vector<path_handle_t>& paths,
+                   const std::vector<std::vector<bed_interval_t>>& path_intervals,
+                   const std::vector<std::string>& ordered_intervals, const bool show_progress);
+
+/// As above, for intervals given in a map from path to (range, name) pairs
 void inject_ranges(MutablePathDeletableHandleGraph& graph,
                    const ska::flat_hash_map<path_handle_t, std::vector<std::pair<interval_t, std::string>>>& path_intervals,
                    const std::vector<std::string>& ordered_intervals, const bool show_progress);
@@ -0,0 +1,200 @@
+#include "instrumentation.hpp"
+#include <fstream>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <sys/resource.h>
+
+namespace odgi {
+
+namespace algorithms {
+
+namespace instrumentation {
+
+struct phase_record_t {
+    std::string name;
+    double start_seconds;
+    double wall_seconds;
+    double cpu_seconds;
+    uint64_t peak_rss_kb;
+    uint64_t items;
+};
+
+struct recorder_t {
+    std::mutex mutex;
+    bool enabled = false;
+    bool written = false;
+    std::string command;
+    std::string filename;
+    std::chrono::time_point<std::chrono::steady_clock> start_time;
+    double start_cpu_seconds = 0;
+    uint64_t peak_rss_kb = 0;             // highest peak seen before the last reset of the high water mark
+    std::vector<Phase*> open_phases;
+    std::vector<phase_record_t> phases;
+};
+
+static recorder_t& recorder() {
+    static recorder_t r;
+    return r;
+}
+
+/// User and system time of all threads of the process.
+static double cpu_seconds() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6
+        + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+}
+
+/// The high water mark of the resident set size in KiB, since the last reset on Linux, else of the process.
+static uint64_t high_water_mark_kb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::strtoull(line.c_str() + 6, nullptr, 10);
+        }
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/// Reset the high water mark to the current RSS, so that a new phase sees its own peak. The peak so far is
+/// first credited to the open phases. Called with the recorder locked.
+static void reset_high_water_mark(recorder_t& r) {
+    const uint64_t hwm = high_water_mark_kb();
+    r.peak_rss_kb = std::max(r.peak_rss_kb, hwm);
+    for (auto* phase : r.open_phases) {
+        phase->peak_rss_kb = std::max(phase->peak_rss_kb, hwm);
+    }
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    if (clear_refs) {
+        clear_refs << "5";
+    }
+}
+
+static double seconds_since(const std::chrono::time_point<std::chrono::steady_clock>& t) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - t;
+    return elapsed.count();
+}
+
+void start(const std::string& command, const std::string& filename) {
+    auto& r = recorder();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    r.enabled = true;
+    r.written = false;
+    r.command = command;
+    r.filename = filename;
+    r.start_time = std::chrono::steady_clock::now();
+    r.start_cpu_seconds = cpu_seconds();
+    // subcommands may exit() on errors or after writing their output
+    static bool registered = false;
+    if (!registered) {
+        std::atexit(finish);
+        registered = true;
+    }
+}
+
+bool enabled() {
+    return recorder().enabled;
+}
+
+uint64_t rss_high_water_mark_kb() {
+    return high_water_mark_kb();
+}
+
+void reset_rss_high_water_mark() {
+    auto& r = recorder();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    reset_high_water_mark(r);
+}
+
+Phase::Phase(const std::string& _name) : name(_name) {
+    auto& r = recorder();
+    if (!r.enabled) return;
+    std::lock_guard<std::mutex> guard(r.mutex);
+    reset_high_water_mark(r);
+    r.open_phases.push_back(this);
+    active = true;
+    start_cpu_seconds = cpu_seconds();
+    start_time = std::chrono::steady_clock::now();
+}
+
+Phase::~Phase() {
+    end();
+}
+
+void Phase::add_items(const uint64_t& n) {
+    items += n;
+}
+
+void Phase::end() {
+    if (!active) return;
+    active = false;
+    auto& r = recorder();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    peak_rss_kb = std::max(peak_rss_kb, high_water_mark_kb());
+    r.open_phases.erase(std::remove(r.open_phases.begin(), r.open_phases.end(), this), r.open_phases.end());
+    std::chrono::duration<double> since_start = start_time - r.start_time;
+    r.phases.push_back({name, since_start.count(), seconds_since(start_time),
+                        cpu_seconds() - start_cpu_seconds, peak_rss_kb, items});
+}
+
+static std::string json_escape(const std::string& s) {
+    std::string escaped;
+    for (auto& c : s) {
+        if (c == '"' || c == '\\') {
+            escaped.push_back('\\');
+            escaped.push_back(c);
+        } else if ((unsigned char)c < 0x20) {
+            escaped.push_back(' ');
+        } else {
+            escaped.push_back(c);
+        }
+    }
+    return escaped;
+}
+
+void write_report(std::ostream& out) {
+    auto& r = recorder();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    // the peaks of all phases were folded into r.peak_rss_kb at each reset, or are still in the high water mark
+    const uint64_t peak = std::max(r.peak_rss_kb, high_water_mark_kb());
+    out << "{" << std::endl
+        << "  \"command\": \"" << json_escape(r.command) << "\"," << std::endl
+        << "  \"wall_seconds\": " << seconds_since(r.start_time) << "," << std::endl
+        << "  \"cpu_seconds\": " << cpu_seconds() - r.start_cpu_seconds << "," << std::endl
+        << "  \"peak_rss_kb\": " << peak << "," << std::endl
+        << "  \"phases\": [";
+    for (uint64_t i = 0; i < r.phases.size(); ++i) {
+        auto& p = r.phases[i];
+        out << (i ? "," : "") << std::endl
+            << "    {\"name\": \"" << json_escape(p.name) << "\""
+            << ", \"start_seconds\": " << p.start_seconds
+            << ", \"wall_seconds\": " << p.wall_seconds
+            << ", \"cpu_seconds\": " << p.cpu_seconds
+            << ", \"peak_rss_kb\": " << p.peak_rss_kb
+            << ", \"items\": " << p.items << "}";
+    }
+    out << std::endl << "  ]" << std::endl << "}" << std::endl;
+}
+
+void finish() {
+    auto& r = recorder();
+    if (!r.enabled || r.written) return;
+    r.written = true;
+    std::ofstream out(r.filename.c_str());
+    if (!out) {
+        std::cerr << "[odgi::" << r.command << "] error: cannot write the statistics to \"" << r.filename << "\"." << std::endl;
+        return;
+    }
+    write_report(out);
+}
+
+}
+
+}
+
+}
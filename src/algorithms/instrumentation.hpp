@@ -0,0 +1,65 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * \file instrumentation.hpp
+ *
+ * Per-phase wall time, CPU time, peak RSS and item counts of a subcommand, reported as JSON through the global
+ * --stats-json option. Phases cost nothing unless recording was started.
+ */
+
+namespace odgi {
+
+namespace algorithms {
+
+namespace instrumentation {
+
+/// Start recording the phases of the command, writing the report to filename when the process finishes.
+void start(const std::string& command, const std::string& filename);
+
+/// True if phases are being recorded.
+bool enabled();
+
+/// The high water mark of the resident set size in KiB since the last reset_rss_high_water_mark() on Linux, else
+/// the peak of the whole process.
+uint64_t rss_high_water_mark_kb();
+
+/// Reset the high water mark to the current RSS where the kernel allows it, crediting the peak so far to the
+/// recorded phases.
+void reset_rss_high_water_mark();
+
+/// Records one phase, from its construction to end() or its destruction. Phases may nest.
+class Phase {
+public:
+    explicit Phase(const std::string& name);
+    ~Phase();
+    Phase(const Phase& other) = delete;
+    Phase& operator=(const Phase& other) = delete;
+
+    /// Count items processed in this phase, e.g. nodes loaded or steps written.
+    void add_items(const uint64_t& n);
+    void end();
+
+    std::string name;
+    uint64_t items = 0;
+    uint64_t peak_rss_kb = 0;
+    double start_cpu_seconds = 0;
+    std::chrono::time_point<std::chrono::steady_clock> start_time;
+    bool active = false;
+};
+
+/// Write the report of the recorded phases as JSON.
+void write_report(std::ostream& out);
+
+/// Write the report to the file given to start, if recording and not yet written.
+void finish();
+
+}
+
+}
+
+}
@@ -0,0 +1,309 @@
+#include "layout_tiles.hpp"
+#include "ips4o.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <omp.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace odgi {
+namespace algorithms {
+namespace layout {
+
+using namespace handlegraph;
+
+static const char layout_tiles_magic[8] = {'O', 'D', 'G', 'I', 'T', 'I', 'L', 'E'};
+constexpr uint64_t layout_tiles_version = 1;
+constexpr uint64_t layout_tiles_max_levels = 16;
+
+uint64_t tile_morton(const uint32_t& x, const uint32_t& y) {
+    auto spread = [](uint64_t v) {
+        v = (v | (v << 16)) & 0x0000ffff0000ffffULL;
+        v = (v | (v << 8)) & 0x00ff00ff00ff00ffULL;
+        v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        v = (v | (v << 2)) & 0x3333333333333333ULL;
+        v = (v | (v << 1)) & 0x5555555555555555ULL;
+        return v;
+    };
+    return spread(x) | (spread(y) << 1);
+}
+
+bool write_layout_tiles(const std::string& filename,
+                        const PathHandleGraph& graph,
+                        const std::vector<double>& X,
+                        const std::vector<double>& Y,
+                        const uint64_t& capacity,
+                        const uint64_t& nthreads) {
+    // open before tiling, so that a bad path fails fast
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) {
+        return false;
+    }
+    std::vector<handle_t> handles;
+    handles.reserve(graph.get_node_count());
+    graph.for_each_handle([&](const handle_t& h) { handles.push_back(h); });
+    const uint64_t n = handles.size();
+
+    layout_tiles_header_t header;
+    std::memcpy(header.magic, layout_tiles_magic, sizeof(header.magic));
+    header.version = layout_tiles_version;
+    header.n_nodes = n;
+    header.capacity = std::max((uint64_t)1, capacity);
+
+    double min_x = std::numeric_limits<double>::max();
+    double min_y = std::numeric_limits<double>::max();
+    double max_x = std::numeric_limits<double>::lowest();
+    double max_y = std::numeric_limits<double>::lowest();
+    for (uint64_t i = 0; i < X.size(); ++i) {
+        min_x = std::min(min_x, X[i]);
+        max_x = std::max(max_x, X[i]);
+        min_y = std::min(min_y, Y[i]);
+        max_y = std::max(max_y, Y[i]);
+    }
+    header.min_x = n ? min_x : 0;
+    header.min_y = n ? min_y : 0;
+    header.extent = n ? std::max(max_x - min_x, max_y - min_y) : 0;
+    if (header.extent <= 0) {
+        header.extent = 1;
+    }
+
+    // refine until the finest tiles hold about capacity nodes on average
+    header.n_levels = 1;
+    while (header.n_levels < layout_tiles_max_levels
+           && (n >> (2 * (header.n_levels - 1))) > header.capacity) {
+        ++header.n_levels;
+    }
+    const uint64_t finest = header.n_levels - 1;
+    const uint64_t grid = 1ULL << finest;
+
+    // place each node in the finest tile holding the midpoint of its segment
+    std::vector<uint64_t> morton(n);
+    std::vector<double> segment_length(n);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (uint64_t i = 0; i < n; ++i) {
+        const uint64_t a = 2 * number_bool_packing::unpack_number(handles[i]);
+        const double mid_x = (X[a] + X[a + 1]) / 2.0;
+        const double mid_y = (Y[a] + Y[a + 1]) / 2.0;
+        auto tile_of = [&](const double& v, const double& min_v) {
+            return (uint32_t)std::min((double)grid - 1, std::max(0.0, std::floor((v - min_v) / header.extent * grid)));
+        };
+        morton[i] = tile_morton(tile_of(mid_x, header.min_x), tile_of(mid_y, header.min_y));
+        segment_length[i] = std::hypot(X[a + 1] - X[a], Y[a + 1] - Y[a]);
+    }
+    // in Morton order, the nodes of every tile at every level are contiguous
+    std::vector<uint64_t> order(n);
+    for (uint64_t i = 0; i < n; ++i) {
+        order[i] = i;
+    }
+    ips4o::parallel::sort(order.begin(), order.end(),
+                          [&](const uint64_t& a, const uint64_t& b) {
+                              return morton[a] < morton[b] || (morton[a] == morton[b] && a < b);
+                          }, nthreads);
+
+    uint64_t max_path = 0;
+    graph.for_each_path_handle([&](const path_handle_t& p) {
+        max_path = std::max(max_path, (uint64_t)as_integer(p));
+    });
+    const int n_buffers = std::max((int)nthreads, omp_get_max_threads());
+    std::vector<std::vector<bool>> seen_paths(n_buffers, std::vector<bool>(max_path + 1, false));
+    std::vector<std::vector<uint64_t>> touched_paths(n_buffers);
+
+    // the directory of every level, with the range of each tile in order
+    std::vector<layout_tiles_level_t> levels(header.n_levels);
+    std::vector<std::vector<layout_tile_t>> directories(header.n_levels);
+    std::vector<std::vector<uint64_t>> tile_begins(header.n_levels);
+    uint64_t offset = sizeof(layout_tiles_header_t) + header.n_levels * sizeof(layout_tiles_level_t);
+    uint64_t n_segments = 0;
+    for (uint64_t l = 0; l < header.n_levels; ++l) {
+        const uint64_t shift = 2 * (finest - l);
+        auto& begins = tile_begins[l];
+        for (uint64_t i = 0; i < n; ++i) {
+            if (i == 0 || (morton[order[i]] >> shift) != (morton[order[i - 1]] >> shift)) {
+                begins.push_back(i);
+            }
+        }
+        begins.push_back(n);
+        auto& directory = directories[l];
+        directory.resize(begins.size() - 1);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+        for (uint64_t t = 0; t < directory.size(); ++t) {
+            const int tid = omp_get_thread_num();
+            auto& seen = seen_paths[tid];
+            auto& touched = touched_paths[tid];
+            auto& tile = directory[t];
+            tile.morton = morton[order[begins[t]]] >> shift;
+            tile.n_nodes = begins[t + 1] - begins[t];
+            tile.length = 0;
+            tile.steps = 0;
+            for (uint64_t i = begins[t]; i < begins[t + 1]; ++i) {
+                const handle_t& h = handles[order[i]];
+                tile.length += graph.get_length(h);
+                tile.steps += graph.get_step_count(h);
+                graph.for_each_step_on_handle(h, [&](const step_handle_t& s) {
+                    const uint64_t p = as_integer(graph.get_path_handle_of_step(s));
+                    if (!seen[p]) {
+                        seen[p] = true;
+                        touched.push_back(p);
+                    }
+                });
+            }
+            tile.n_paths = touched.size();
+            for (auto& p : touched) {
+                seen[p] = false;
+            }
+            touched.clear();
+            tile.n_segments = l == finest ? tile.n_nodes : std::min(tile.n_nodes, header.capacity);
+        }
+        for (auto& tile : directory) {
+            tile.first_segment = n_segments;
+            n_segments += tile.n_segments;
+        }
+        levels[l].tiles_offset = offset;
+        levels[l].n_tiles = directory.size();
+        offset += directory.size() * sizeof(layout_tile_t);
+    }
+    header.segments_offset = offset;
+
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)levels.data(), levels.size() * sizeof(layout_tiles_level_t));
+    for (auto& directory : directories) {
+        out.write((const char*)directory.data(), directory.size() * sizeof(layout_tile_t));
+    }
+
+    // one level of segments is held in memory at a time
+    for (uint64_t l = 0; l < header.n_levels; ++l) {
+        auto& directory = directories[l];
+        auto& begins = tile_begins[l];
+        const uint64_t level_first = directory.empty() ? 0 : directory.front().first_segment;
+        std::vector<layout_tile_segment_t> segments(
+                directory.empty() ? 0 : directory.back().first_segment + directory.back().n_segments - level_first);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+        for (uint64_t t = 0; t < directory.size(); ++t) {
+            auto& tile = directory[t];
+            std::vector<uint64_t> kept(order.begin() + begins[t], order.begin() + begins[t + 1]);
+            if (kept.size() > tile.n_segments) {
+                // coarser tiles keep their longest segments
+                std::nth_element(kept.begin(), kept.begin() + tile.n_segments, kept.end(),
+                                 [&](const uint64_t& a, const uint64_t& b) {
+                                     return segment_length[a] > segment_length[b]
+                                            || (segment_length[a] == segment_length[b] && a < b);
+                                 });
+                kept.resize(tile.n_segments);
+                std::sort(kept.begin(), kept.end());
+            }
+            auto* segment = &segments[tile.first_segment - level_first];
+            for (auto& i : kept) {
+                const uint64_t a = 2 * number_bool_packing::unpack_number(handles[i]);
+                *segment++ = {(uint64_t)graph.get_id(handles[i]),
+                              (float)X[a], (float)Y[a],
+                              (float)X[a + 1], (float)Y[a + 1]};
+            }
+        }
+        out.write((const char*)segments.data(), segments.size() * sizeof(layout_tile_segment_t));
+        std::vector<uint64_t>().swap(begins);
+    }
+    out.close();
+    return !out.fail();
+}
+
+LayoutTiles::~LayoutTiles() {
+    close();
+}
+
+bool LayoutTiles::open(const std::string& filename) {
+    close();
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(layout_tiles_header_t)) {
+        close();
+        return false;
+    }
+    size = st.st_size;
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        close();
+        return false;
+    }
+    data = (const char*)mapped;
+    if (std::memcmp(header().magic, layout_tiles_magic, sizeof(layout_tiles_magic)) != 0
+        || header().version != layout_tiles_version) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void LayoutTiles::close() {
+    if (data) {
+        munmap((void*)data, size);
+        data = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    size = 0;
+}
+
+const layout_tiles_header_t& LayoutTiles::header() const {
+    return *(const layout_tiles_header_t*)data;
+}
+
+const layout_tiles_level_t* LayoutTiles::levels() const {
+    return (const layout_tiles_level_t*)(data + sizeof(layout_tiles_header_t));
+}
+
+const layout_tile_t* LayoutTiles::get_tile(const uint64_t& level, const uint32_t& x, const uint32_t& y) const {
+    if (level >= header().n_levels) {
+        return nullptr;
+    }
+    const layout_tiles_level_t& l = levels()[level];
+    const layout_tile_t* begin = (const layout_tile_t*)(data + l.tiles_offset);
+    const layout_tile_t* end = begin + l.n_tiles;
+    const uint64_t key = tile_morton(x, y);
+    const layout_tile_t* tile = std::lower_bound(begin, end, key,
+                                                 [](const layout_tile_t& t, const uint64_t& k) {
+                                                     return t.morton < k;
+                                                 });
+    return tile != end && tile->morton == key ? tile : nullptr;
+}
+
+void LayoutTiles::for_each_tile_in_view(const uint64_t& level,
+                                        const double& min_x, const double& min_y,
+                                        const double& max_x, const double& max_y,
+                                        const std::function<void(const layout_tile_t&)>& func) const {
+    if (level >= header().n_levels) {
+        return;
+    }
+    const uint64_t grid = 1ULL << level;
+    auto tile_of = [&](const double& v, const double& min_v) {
+        return (uint32_t)std::min((double)grid - 1, std::max(0.0, std::floor((v - min_v) / header().extent * grid)));
+    };
+    const uint32_t x0 = tile_of(min_x, header().min_x);
+    const uint32_t x1 = tile_of(max_x, header().min_x);
+    const uint32_t y0 = tile_of(min_y, header().min_y);
+    const uint32_t y1 = tile_of(max_y, header().min_y);
+    for (uint32_t y = y0; y <= y1; ++y) {
+        for (uint32_t x = x0; x <= x1; ++x) {
+            const layout_tile_t* tile = get_tile(level, x, y);
+            if (tile) {
+                func(*tile);
+            }
+        }
+    }
+}
+
+const layout_tile_segment_t* LayoutTiles::segments(const layout_tile_t& tile) const {
+    return (const layout_tile_segment_t*)(data + header().segments_offset) + tile.first_segment;
+}
+
+}
+}
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <functional>
+#include <handlegraph/types.hpp>
+#include <handlegraph/util.hpp>
+#include <handlegraph/path_handle_graph.hpp>
+
+/**
+ * \file layout_tiles.hpp
+ *
+ * A level-of-detail tile pyramid of a 2D layout, stored in a flat binary file that can be memory-mapped.
+ */
+
+namespace odgi {
+
+namespace algorithms {
+
+namespace layout {
+
+using namespace handlegraph;
+
+/// Default number of node segments kept in a tile above the finest level.
+constexpr uint64_t layout_tiles_default_capacity = 4096;
+
+/*
+  The file is a sequence of fixed-size, 8-byte aligned records, so a viewer can mmap it and read the
+  tiles it needs in place:
+    - one layout_tiles_header_t;
+    - one layout_tiles_level_t per level, from the root (level 0, a single tile) to the finest level;
+      level l splits the square extent of the layout into 2^l x 2^l tiles;
+    - for each level, the layout_tile_t directory of its non-empty tiles, sorted by the Morton code of
+      their (x, y) tile coordinates;
+    - all layout_tile_segment_t records, each tile's segments being contiguous.
+  A node belongs to the tile holding the midpoint of its segment. Tiles of the finest level hold all of
+  their nodes; coarser tiles hold their capacity longest segments, plus summaries of all their nodes.
+*/
+
+struct layout_tiles_header_t {
+    char magic[8];
+    uint64_t version;
+    double min_x;
+    double min_y;
+    double extent;           // side of the square covered by the root tile
+    uint64_t n_levels;
+    uint64_t n_nodes;
+    uint64_t capacity;
+    uint64_t segments_offset; // byte offset of the first segment record
+};
+
+struct layout_tiles_level_t {
+    uint64_t tiles_offset;   // byte offset of the level's tile directory
+    uint64_t n_tiles;
+};
+
+struct layout_tile_t {
+    uint64_t morton;         // interleaved bits of the tile's x (even bits) and y (odd bits) coordinates
+    uint64_t n_nodes;        // all nodes in the tile, including those not stored as segments
+    uint64_t length;         // total node length in bp
+    uint64_t steps;          // total number of path steps on the tile's nodes
+    uint64_t n_paths;        // number of distinct paths visiting the tile
+    uint64_t first_segment;  // index of the tile's first segment record
+    uint64_t n_segments;
+};
+
+struct layout_tile_segment_t {
+    uint64_t id;             // node id
+    float x0;
+    float y0;
+    float x1;
+    float y1;
+};
+
+/// Interleave the bits of x and y into a Morton code.
+uint64_t tile_morton(const uint32_t& x, const uint32_t& y);
+
+/// Write the tile pyramid of the layout X, Y (two coordinates per node rank, as in Layout) of graph.
+/// Returns false if filename cannot be opened or written.
+bool write_layout_tiles(const std::string& filename,
+                        const PathHandleGraph& graph,
+                        const std::vector<double>& X,
+                        const std::vector<double>& Y,
+                        const uint64_t& capacity,
+                        const uint64_t& nthreads);
+
+/// A read-only view of a tile pyramid file, which is memory-mapped rather than loaded.
+class LayoutTiles {
+public:
+    LayoutTiles() = default;
+    ~LayoutTiles();
+    LayoutTiles(const LayoutTiles& other) = delete;
+    LayoutTiles& operator=(const LayoutTiles& other) = delete;
+
+    /// Map the file, returning false if it cannot be opened or is not a tile pyramid.
+    bool open(const std::string& filename);
+    void close();
+
+    const layout_tiles_header_t& header() const;
+    /// The tile at (x, y) of the given level, or nullptr if the tile is empty.
+    const layout_tile_t* get_tile(const uint64_t& level, const uint32_t& x, const uint32_t& y) const;
+    /// Iterate the non-empty tiles of the level intersecting the rectangle [min_x, max_x] x [min_y, max_y].
+    void for_each_tile_in_view(const uint64_t& level,
+                               const double& min_x, const double& min_y,
+                               const double& max_x, const double& max_y,
+                               const std::function<void(const layout_tile_t&)>& func) const;
+    /// The segments stored in the tile.
+    const layout_tile_segment_t* segments(const layout_tile_t& tile) const;
+
+private:
+    const char* data = nullptr;
+    uint64_t size = 0;
+    int fd = -1;
+
+    const layout_tiles_level_t* levels() const;
+};
+
+}
+
+}
+
+}
@@ -1,4 +1,8 @@
 #include "matrix_writer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <omp.h>
+#include "ips4o.hpp"
 
 namespace odgi {
 namespace algorithms {
@@ -39,5 +43,147 @@ void write_as_sparse_matrix(std::ostream& out, const PathHandleGraph& graph, boo
         });
 }
 
+sparse_matrix_t build_sparse_matrix(const PathHandleGraph& graph, bool weight_by_edge_depth, bool weight_by_edge_delta,
+                                    const uint64_t& nthreads) {
+    const int n_buffers = std::max((int)nthreads, omp_get_max_threads());
+
+    // collect the edges, then sort them so that they can be found by binary search
+    std::vector<std::vector<edge_t>> thread_edges(n_buffers);
+    graph.for_each_edge([&](const edge_t& edge) {
+            thread_edges[omp_get_thread_num()].push_back(edge);
+        }, true);
+    std::vector<edge_t> edges;
+    for (auto& e : thread_edges) {
+        edges.insert(edges.end(), e.begin(), e.end());
+        std::vector<edge_t>().swap(e);
+    }
+    auto edge_less = [](const edge_t& a, const edge_t& b) {
+        return as_integer(a.first) < as_integer(b.first)
+            || (as_integer(a.first) == as_integer(b.first) && as_integer(a.second) < as_integer(b.second));
+    };
+    ips4o::parallel::sort(edges.begin(), edges.end(), edge_less, nthreads);
+
+    std::vector<double> edge_weights(edges.size(), 1);
+    if (weight_by_edge_depth && !weight_by_edge_delta) {
+        // how many times do the paths cross each edge, in either direction?
+        std::vector<path_handle_t> paths;
+        graph.for_each_path_handle([&](const path_handle_t& path) {
+                paths.push_back(path);
+            });
+        const bool dense = (uint64_t)n_buffers * edges.size() * sizeof(uint64_t) <= sparse_matrix_dense_budget;
+        std::vector<std::vector<uint64_t>> thread_counts(dense ? n_buffers : 1, std::vector<uint64_t>(edges.size(), 0));
+#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+        for (uint64_t i = 0; i < paths.size(); ++i) {
+            auto& counts = thread_counts[dense ? omp_get_thread_num() : 0];
+            auto count = [&](const handle_t& prev, const handle_t& next) {
+                const edge_t edge = graph.edge_handle(prev, next);
+                const auto f = std::lower_bound(edges.begin(), edges.end(), edge, edge_less);
+                if (f != edges.end() && *f == edge) {
+                    if (dense) {
+                        ++counts[f - edges.begin()];
+                    } else {
+#pragma omp atomic
+                        ++counts[f - edges.begin()];
+                    }
+                }
+            };
+            // like write_as_sparse_matrix, this does not count the wrap of a circular path from its last to its first step
+            bool first = true;
+            handle_t prev;
+            graph.for_each_step_in_path(paths[i], [&](const step_handle_t& step) {
+                    const handle_t h = graph.get_handle_of_step(step);
+                    if (!first) {
+                        count(prev, h);
+                    }
+                    first = false;
+                    prev = h;
+                });
+        }
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+        for (uint64_t j = 0; j < edges.size(); ++j) {
+            uint64_t depth = 0;
+            for (auto& counts : thread_counts) {
+                depth += counts[j];
+            }
+            edge_weights[j] = depth;
+        }
+    } else if (weight_by_edge_delta) {
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+        for (uint64_t j = 0; j < edges.size(); ++j) {
+            double delta = std::abs(graph.get_id(edges[j].first) - graph.get_id(edges[j].second));
+            if (delta == 0) delta = 1;
+            edge_weights[j] = 1 / delta;
+        }
+    }
+
+    sparse_matrix_t matrix;
+    matrix.n_rows = graph.max_node_id();
+    matrix.n_cols = graph.max_node_id();
+    // count the entries of each row, then fill the rows through per-row cursors
+    std::vector<uint64_t> cursors(matrix.n_rows + 1, 0);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (uint64_t j = 0; j < edges.size(); ++j) {
+        const uint64_t a = graph.get_id(edges[j].first) - 1;
+        const uint64_t b = graph.get_id(edges[j].second) - 1;
+#pragma omp atomic
+        ++cursors[a + 1];
+#pragma omp atomic
+        ++cursors[b + 1];
+    }
+    for (uint64_t i = 0; i < matrix.n_rows; ++i) {
+        cursors[i + 1] += cursors[i];
+    }
+    matrix.offsets = cursors;
+    matrix.columns.resize(edges.size() * 2);
+    matrix.weights.resize(edges.size() * 2);
+    auto add_entry = [&](const uint64_t& row, const uint64_t& column, const double& weight) {
+        uint64_t k;
+#pragma omp atomic capture
+        k = cursors[row]++;
+        matrix.columns[k] = column;
+        matrix.weights[k] = weight;
+    };
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (uint64_t j = 0; j < edges.size(); ++j) {
+        const uint64_t a = graph.get_id(edges[j].first) - 1;
+        const uint64_t b = graph.get_id(edges[j].second) - 1;
+        add_entry(a, b, edge_weights[j]);
+        add_entry(b, a, edge_weights[j]);
+    }
+    // the fill order depends on the threads, so sort each row to get a deterministic matrix
+#pragma omp parallel for schedule(dynamic,1024) num_threads(nthreads)
+    for (uint64_t i = 0; i < matrix.n_rows; ++i) {
+        const uint64_t begin = matrix.offsets[i];
+        const uint64_t end = matrix.offsets[i + 1];
+        if (end - begin > 1) {
+            std::vector<std::pair<uint64_t, double>> row;
+            row.reserve(end - begin);
+            for (uint64_t k = begin; k < end; ++k) {
+                row.emplace_back(matrix.columns[k], matrix.weights[k]);
+            }
+            std::sort(row.begin(), row.end());
+            for (uint64_t k = begin; k < end; ++k) {
+                matrix.columns[k] = row[k - begin].first;
+                matrix.weights[k] = row[k - begin].second;
+            }
+        }
+    }
+    return matrix;
+}
+
+void write_as_binary_sparse_matrix(std::ostream& out, const sparse_matrix_t& matrix) {
+    sparse_matrix_header_t header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "ODGICSR", 7);
+    header.version = 1;
+    header.n_rows = matrix.n_rows;
+    header.n_cols = matrix.n_cols;
+    header.nnz = matrix.columns.size();
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)matrix.offsets.data(), matrix.offsets.size() * sizeof(uint64_t));
+    out.write((const char*)matrix.columns.data(), matrix.columns.size() * sizeof(uint64_t));
+    out.write((const char*)matrix.weights.data(), matrix.weights.size() * sizeof(double));
+}
+
 }
 }
@@ -7,6 +7,7 @@
  */
 
 #include <iostream>
+#include <vector>
 #include <handlegraph/handle_graph.hpp>
 #include <handlegraph/path_handle_graph.hpp>
 #include <handlegraph/util.hpp>
@@ -16,7 +17,45 @@ namespace algorithms {
 
 using namespace handlegraph;
 
+/// Above this many bytes for the per-thread edge depth counters we fall back to shared atomic counters.
+constexpr uint64_t sparse_matrix_dense_budget = 1ULL << 30;
+
+/// The symmetric adjacency matrix of a graph in compressed sparse row form. Row and column i stand for node id i + 1.
+/// Every edge gives one entry in the row of each of its nodes, so an edge between two nodes in different orientations
+/// gives duplicate entries, which sparse matrix libraries sum up.
+struct sparse_matrix_t {
+    uint64_t n_rows = 0;
+    uint64_t n_cols = 0;
+    std::vector<uint64_t> offsets;  // n_rows + 1 offsets into columns and weights
+    std::vector<uint64_t> columns;  // sorted within each row
+    std::vector<double> weights;
+};
+
+/*
+  The binary matrix file is little-endian, made of:
+    - one sparse_matrix_header_t;
+    - n_rows + 1 uint64_t row offsets;
+    - nnz uint64_t column indices;
+    - nnz double weights.
+  It can be read with numpy.fromfile and handed to scipy.sparse.csr_matrix without parsing.
+*/
+struct sparse_matrix_header_t {
+    char magic[8];      // "ODGICSR" and a NUL byte
+    uint64_t version;
+    uint64_t n_rows;
+    uint64_t n_cols;
+    uint64_t nnz;
+};
+
 void write_as_sparse_matrix(std::ostream& out, const PathHandleGraph& graph, bool weight_by_edge_depth, bool weight_by_edge_delta);
 
+/// Build the matrix written by write_as_sparse_matrix. Edge depths are accumulated by walking the paths in parallel,
+/// each thread counting into its own array when these fit in sparse_matrix_dense_budget.
+sparse_matrix_t build_sparse_matrix(const PathHandleGraph& graph, bool weight_by_edge_depth, bool weight_by_edge_delta,
+                                    const uint64_t& nthreads);
+
+/// Write the matrix in the binary CSR format.
+void write_as_binary_sparse_matrix(std::ostream& out, const sparse_matrix_t& matrix);
+
 }
 }
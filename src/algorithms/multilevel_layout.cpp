@@ -0,0 +1,416 @@
+#include "multilevel_layout.hpp"
+#include "path_sgd_layout.hpp"
+#include "ips4o.hpp"
+#include <omp.h>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace odgi {
+namespace algorithms {
+
+layout_level_t graph_layout_level(const PathHandleGraph& graph,
+                                  const std::vector<path_handle_t>& paths,
+                                  const uint64_t& nthreads) {
+    layout_level_t level;
+    level.n_nodes = graph.get_node_count();
+    level.length.resize(level.n_nodes);
+    graph.for_each_handle([&](const handle_t& h) {
+            level.length[number_bool_packing::unpack_number(h)] = graph.get_length(h);
+        }, true);
+    level.path_offsets.resize(paths.size() + 1, 0);
+    for (uint64_t p = 0; p < paths.size(); ++p) {
+        level.path_offsets[p + 1] = level.path_offsets[p] + graph.get_step_count(paths[p]);
+    }
+    const uint64_t n_steps = level.path_offsets.back();
+    level.steps.resize(n_steps);
+    level.begin.resize(n_steps);
+    level.end.resize(n_steps);
+#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+    for (uint64_t p = 0; p < paths.size(); ++p) {
+        uint64_t k = level.path_offsets[p];
+        uint64_t pos = 0;
+        graph.for_each_step_in_path(paths[p], [&](const step_handle_t& s) {
+                const uint64_t rank = number_bool_packing::unpack_number(graph.get_handle_of_step(s));
+                level.steps[k] = rank;
+                level.begin[k] = pos;
+                pos += level.length[rank];
+                level.end[k] = pos;
+                ++k;
+            });
+    }
+    return level;
+}
+
+layout_level_t coarsen_layout_level(layout_level_t& fine, const uint64_t& nthreads) {
+    const uint64_t n_paths = fine.path_offsets.size() - 1;
+    const int n_buffers = std::max((int)nthreads, omp_get_max_threads());
+
+    // weigh each pair of nodes by how often the paths step from one to the other
+    std::vector<std::vector<std::pair<uint64_t, uint64_t>>> thread_pairs(n_buffers);
+#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+    for (uint64_t p = 0; p < n_paths; ++p) {
+        auto& pairs = thread_pairs[omp_get_thread_num()];
+        for (uint64_t k = fine.path_offsets[p] + 1; k < fine.path_offsets[p + 1]; ++k) {
+            const uint64_t a = fine.steps[k - 1];
+            const uint64_t b = fine.steps[k];
+            if (a != b) {
+                pairs.emplace_back(std::min(a, b), std::max(a, b));
+            }
+        }
+    }
+    std::vector<std::pair<uint64_t, uint64_t>> pairs;
+    for (auto& t : thread_pairs) {
+        pairs.insert(pairs.end(), t.begin(), t.end());
+        std::vector<std::pair<uint64_t, uint64_t>>().swap(t);
+    }
+    ips4o::parallel::sort(pairs.begin(), pairs.end(), std::less<std::pair<uint64_t, uint64_t>>(), nthreads);
+
+    // the weighted adjacency of the nodes, in compressed sparse rows
+    std::vector<uint64_t> adj_offsets(fine.n_nodes + 1, 0);
+    for (uint64_t k = 0; k < pairs.size(); ++k) {
+        if (k == 0 || pairs[k] != pairs[k - 1]) {
+            ++adj_offsets[pairs[k].first + 1];
+            ++adj_offsets[pairs[k].second + 1];
+        }
+    }
+    for (uint64_t i = 0; i < fine.n_nodes; ++i) {
+        adj_offsets[i + 1] += adj_offsets[i];
+    }
+    std::vector<std::pair<uint64_t, uint64_t>> adj(adj_offsets.back()); // (neighbor, weight)
+    {
+        std::vector<uint64_t> cursors(adj_offsets.begin(), adj_offsets.end() - 1);
+        uint64_t k = 0;
+        while (k < pairs.size()) {
+            uint64_t l = k;
+            while (l < pairs.size() && pairs[l] == pairs[k]) {
+                ++l;
+            }
+            adj[cursors[pairs[k].first]++] = std::make_pair(pairs[k].second, l - k);
+            adj[cursors[pairs[k].second]++] = std::make_pair(pairs[k].first, l - k);
+            k = l;
+        }
+    }
+    std::vector<std::pair<uint64_t, uint64_t>>().swap(pairs);
+
+    // match every node with its unmatched neighbor of heaviest adjacency, in node order
+    const uint64_t unmatched = std::numeric_limits<uint64_t>::max();
+    layout_level_t coarse;
+    fine.parent.assign(fine.n_nodes, unmatched);
+    for (uint64_t u = 0; u < fine.n_nodes; ++u) {
+        if (fine.parent[u] != unmatched) {
+            continue;
+        }
+        uint64_t best = unmatched;
+        uint64_t best_weight = 0;
+        for (uint64_t k = adj_offsets[u]; k < adj_offsets[u + 1]; ++k) {
+            const uint64_t v = adj[k].first;
+            if (fine.parent[v] == unmatched && adj[k].second > best_weight) {
+                best = v;
+                best_weight = adj[k].second;
+            }
+        }
+        fine.parent[u] = coarse.n_nodes;
+        coarse.length.push_back(fine.length[u]);
+        if (best != unmatched) {
+            fine.parent[best] = coarse.n_nodes;
+            coarse.length.back() += fine.length[best];
+        }
+        ++coarse.n_nodes;
+    }
+
+    // project the paths, merging consecutive steps on the same coarse node
+    std::vector<uint64_t> path_counts(n_paths + 1, 0);
+#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+    for (uint64_t p = 0; p < n_paths; ++p) {
+        uint64_t count = 0;
+        for (uint64_t k = fine.path_offsets[p]; k < fine.path_offsets[p + 1]; ++k) {
+            if (k == fine.path_offsets[p] || fine.parent[fine.steps[k]] != fine.parent[fine.steps[k - 1]]) {
+                ++count;
+            }
+        }
+        path_counts[p + 1] = count;
+    }
+    for (uint64_t p = 0; p < n_paths; ++p) {
+        path_counts[p + 1] += path_counts[p];
+    }
+    coarse.path_offsets = path_counts;
+    const uint64_t n_steps = coarse.path_offsets.back();
+    coarse.steps.resize(n_steps);
+    coarse.begin.resize(n_steps);
+    coarse.end.resize(n_steps);
+#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+    for (uint64_t p = 0; p < n_paths; ++p) {
+        uint64_t j = coarse.path_offsets[p];
+        for (uint64_t k = fine.path_offsets[p]; k < fine.path_offsets[p + 1]; ++k) {
+            const uint64_t node = fine.parent[fine.steps[k]];
+            if (k == fine.path_offsets[p] || node != coarse.steps[j - 1]) {
+                coarse.steps[j] = node;
+                coarse.begin[j] = fine.begin[k];
+                ++j;
+            }
+            coarse.end[j - 1] = fine.end[k];
+        }
+    }
+    return coarse;
+}
+
+/// Push apart the nodes closer than the mean of their lengths, looking for them in the 3x3 neighborhood of their grid cell.
+static void layout_level_repulsion(const layout_level_t& level,
+                                   const double& strength,
+                                   const uint64_t& nthreads,
+                                   std::vector<std::atomic<double>>& X,
+                                   std::vector<std::atomic<double>>& Y) {
+    const uint64_t n = level.n_nodes;
+    if (n < 2) {
+        return;
+    }
+    double total_length = 0;
+    for (auto& l : level.length) {
+        total_length += l;
+    }
+    // twice the mean node length
+    const double cell = std::max(1.0, 2 * total_length / n);
+    // nodes examined per cell, bounding the work in dense clumps
+    const uint64_t max_cell_nodes = 32;
+    typedef std::pair<int64_t, int64_t> cell_t;
+    std::vector<std::pair<cell_t, uint64_t>> cells(n);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (uint64_t i = 0; i < n; ++i) {
+        cells[i] = std::make_pair(cell_t((int64_t)std::floor(X[i].load() / cell), (int64_t)std::floor(Y[i].load() / cell)), i);
+    }
+    ips4o::parallel::sort(cells.begin(), cells.end(), std::less<std::pair<cell_t, uint64_t>>(), nthreads);
+    std::vector<double> new_X(n), new_Y(n);
+#pragma omp parallel for schedule(dynamic,1024) num_threads(nthreads)
+    for (uint64_t i = 0; i < n; ++i) {
+        const double x = X[i].load();
+        const double y = Y[i].load();
+        const cell_t c((int64_t)std::floor(x / cell), (int64_t)std::floor(y / cell));
+        double move_x = 0;
+        double move_y = 0;
+        for (int64_t cx = c.first - 1; cx <= c.first + 1; ++cx) {
+            for (int64_t cy = c.second - 1; cy <= c.second + 1; ++cy) {
+                auto it = std::lower_bound(cells.begin(), cells.end(), std::make_pair(cell_t(cx, cy), (uint64_t)0));
+                for (uint64_t seen = 0; it != cells.end() && it->first == cell_t(cx, cy) && seen < max_cell_nodes; ++it, ++seen) {
+                    const uint64_t j = it->second;
+                    if (j == i) {
+                        continue;
+                    }
+                    const double radius = std::min(cell, (double)(level.length[i] + level.length[j]) / 2);
+                    double dx = x - X[j].load();
+                    double dy = y - Y[j].load();
+                    if (dx == 0 && dy == 0) {
+                        // split coincident nodes deterministically
+                        dx = i < j ? -1e-9 : 1e-9;
+                    }
+                    const double dist = std::sqrt(dx * dx + dy * dy);
+                    if (dist < radius) {
+                        const double push = strength * (radius - dist) / 2 / dist;
+                        move_x += dx * push;
+                        move_y += dy * push;
+                    }
+                }
+            }
+        }
+        new_X[i] = x + move_x;
+        new_Y[i] = y + move_y;
+    }
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (uint64_t i = 0; i < n; ++i) {
+        X[i].store(new_X[i]);
+        Y[i].store(new_Y[i]);
+    }
+}
+
+/// Path-guided SGD on one level. Jump lengths along the paths are drawn log-uniformly, which approximates the
+/// Zipfian sampling of path_linear_sgd_layout at theta = 1 without precomputing zetas for every level.
+static void layout_level_sgd(const layout_level_t& level,
+                             const double& eta_max,
+                             const double& eps,
+                             const uint64_t& iter_max,
+                             const bool& repulsion,
+                             const uint64_t& seed,
+                             const uint64_t& nthreads,
+                             std::vector<std::atomic<double>>& X,
+                             std::vector<std::atomic<double>>& Y) {
+    const uint64_t n_steps = level.steps.size();
+    if (n_steps < 2) {
+        return;
+    }
+    const uint64_t n_paths = level.path_offsets.size() - 1;
+    std::vector<uint64_t> step_path(n_steps);
+#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+    for (uint64_t p = 0; p < n_paths; ++p) {
+        for (uint64_t k = level.path_offsets[p]; k < level.path_offsets[p + 1]; ++k) {
+            step_path[k] = p;
+        }
+    }
+    const std::vector<double> etas = path_linear_sgd_layout_schedule(1.0 / eta_max, 1.0, iter_max, 0, eps);
+    const uint64_t term_updates = 10 * n_steps;
+    for (uint64_t iter = 0; iter < iter_max; ++iter) {
+        const double eta = etas[iter];
+#pragma omp parallel num_threads(nthreads)
+        {
+            const uint64_t tid = omp_get_thread_num();
+            const uint64_t n_local = term_updates / omp_get_num_threads() + 1;
+            XoshiroCpp::Xoshiro256Plus gen(seed + iter * nthreads + tid);
+            std::uniform_int_distribution<uint64_t> dis_step(0, n_steps - 1);
+            std::uniform_real_distribution<double> dis_unit(0, 1);
+            for (uint64_t t = 0; t < n_local; ++t) {
+                const uint64_t a = dis_step(gen);
+                const uint64_t first = level.path_offsets[step_path[a]];
+                const uint64_t last = level.path_offsets[step_path[a] + 1] - 1;
+                if (first == last) {
+                    continue;
+                }
+                const bool backward = a == last || (a > first && dis_unit(gen) < 0.5);
+                const uint64_t max_jump = backward ? a - first : last - a;
+                const uint64_t jump = std::min(max_jump, std::max((uint64_t)1,
+                        (uint64_t)std::floor(std::exp(dis_unit(gen) * std::log((double)max_jump + 1)))));
+                const uint64_t b = backward ? a - jump : a + jump;
+                const uint64_t i = level.steps[a];
+                const uint64_t j = level.steps[b];
+                if (i == j) {
+                    continue;
+                }
+                double d_ij = std::abs((double)(level.begin[a] + level.end[a]) / 2 - (double)(level.begin[b] + level.end[b]) / 2);
+                if (d_ij == 0) {
+                    d_ij = 1e-9;
+                }
+                const double mu = std::min(1.0, eta / d_ij);
+                double dx = X[i].load() - X[j].load();
+                const double dy = Y[i].load() - Y[j].load();
+                if (dx == 0) {
+                    dx = 1e-9; // avoid nan
+                }
+                const double mag = std::sqrt(dx * dx + dy * dy);
+                const double r = mu * (mag - d_ij) / 2 / mag;
+                X[i].store(X[i].load() - r * dx);
+                Y[i].store(Y[i].load() - r * dy);
+                X[j].store(X[j].load() + r * dx);
+                Y[j].store(Y[j].load() + r * dy);
+            }
+        }
+        if (repulsion) {
+            layout_level_repulsion(level, 0.5 * (1.0 - (double)iter / (double)iter_max), nthreads, X, Y);
+        }
+    }
+}
+
+double multilevel_path_sgd_layout(const PathHandleGraph& graph,
+                                  const std::vector<path_handle_t>& path_sgd_use_paths,
+                                  const uint64_t& coarsest_node_count,
+                                  const uint64_t& iter_max,
+                                  const double& eps,
+                                  const bool& repulsion,
+                                  const uint64_t& nthreads,
+                                  const bool& progress,
+                                  std::vector<std::atomic<double>>& X,
+                                  std::vector<std::atomic<double>>& Y) {
+    std::vector<layout_level_t> levels;
+    levels.push_back(graph_layout_level(graph, path_sgd_use_paths, nthreads));
+    while (levels.back().n_nodes > coarsest_node_count) {
+        layout_level_t coarse = coarsen_layout_level(levels.back(), nthreads);
+        // stop when the matching no longer shrinks the graph
+        if (coarse.n_nodes > 0.9 * levels.back().n_nodes) {
+            levels.back().parent.clear();
+            break;
+        }
+        levels.push_back(std::move(coarse));
+    }
+    if (progress) {
+        for (uint64_t l = 0; l < levels.size(); ++l) {
+            std::cerr << "[odgi::multilevel_path_sgd_layout] level " << l << ": " << levels[l].n_nodes << " nodes, "
+                      << levels[l].steps.size() << " steps" << std::endl;
+        }
+    }
+    if (levels.size() < 2) {
+        return 0;
+    }
+
+    // restrict the initial layout to every level, placing each node at the length-weighted mean of its children
+    const uint64_t n_levels = levels.size();
+    std::vector<std::vector<double>> init_X(n_levels), init_Y(n_levels);
+    init_X[0].resize(levels[0].n_nodes);
+    init_Y[0].resize(levels[0].n_nodes);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (uint64_t i = 0; i < levels[0].n_nodes; ++i) {
+        init_X[0][i] = (X[2 * i].load() + X[2 * i + 1].load()) / 2;
+        init_Y[0][i] = (Y[2 * i].load() + Y[2 * i + 1].load()) / 2;
+    }
+    for (uint64_t l = 1; l < n_levels; ++l) {
+        const auto& fine = levels[l - 1];
+        init_X[l].assign(levels[l].n_nodes, 0);
+        init_Y[l].assign(levels[l].n_nodes, 0);
+        std::vector<double> weight(levels[l].n_nodes, 0);
+        for (uint64_t i = 0; i < fine.n_nodes; ++i) {
+            const double w = std::max((uint64_t)1, fine.length[i]);
+            init_X[l][fine.parent[i]] += w * init_X[l - 1][i];
+            init_Y[l][fine.parent[i]] += w * init_Y[l - 1][i];
+            weight[fine.parent[i]] += w;
+        }
+        for (uint64_t i = 0; i < levels[l].n_nodes; ++i) {
+            init_X[l][i] /= weight[i];
+            init_Y[l][i] /= weight[i];
+        }
+    }
+
+    // the largest step span of a level bounds the distances that the finer level still has to fix
+    auto max_step_span = [&](const layout_level_t& level) {
+        uint64_t span = 1;
+        for (uint64_t k = 0; k < level.steps.size(); ++k) {
+            span = std::max(span, level.end[k] - level.begin[k]);
+        }
+        return (double)span;
+    };
+
+    // lay out the coarsest level, then carry each layout down, moving every node along with its parent
+    std::vector<std::atomic<double>> parent_X, parent_Y;
+    for (uint64_t l = n_levels - 1; l >= 1; --l) {
+        const auto& level = levels[l];
+        std::vector<std::atomic<double>> level_X(level.n_nodes), level_Y(level.n_nodes);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+        for (uint64_t i = 0; i < level.n_nodes; ++i) {
+            double x = init_X[l][i];
+            double y = init_Y[l][i];
+            if (l + 1 < n_levels) {
+                const uint64_t p = level.parent[i];
+                x += parent_X[p].load() - init_X[l + 1][p];
+                y += parent_Y[p].load() - init_Y[l + 1][p];
+            }
+            level_X[i].store(x);
+            level_Y[i].store(y);
+        }
+        double eta_max = 0;
+        if (l + 1 == n_levels) {
+            for (uint64_t p = 0; p + 1 < level.path_offsets.size(); ++p) {
+                if (level.path_offsets[p + 1] > level.path_offsets[p]) {
+                    eta_max = std::max(eta_max, (double)level.end[level.path_offsets[p + 1] - 1]);
+                }
+            }
+        } else {
+            eta_max = max_step_span(levels[l + 1]);
+        }
+        layout_level_sgd(level, std::max(1.0, eta_max), eps, std::max((uint64_t)2, iter_max), repulsion,
+                         9399220 + l * 1000003, nthreads, level_X, level_Y);
+        parent_X.swap(level_X);
+        parent_Y.swap(level_Y);
+    }
+
+    const auto& finest = levels[0];
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (uint64_t i = 0; i < finest.n_nodes; ++i) {
+        const uint64_t p = finest.parent[i];
+        const double move_x = parent_X[p].load() - init_X[1][p];
+        const double move_y = parent_Y[p].load() - init_Y[1][p];
+        for (uint64_t e = 2 * i; e <= 2 * i + 1; ++e) {
+            X[e].store(X[e].load() + move_x);
+            Y[e].store(Y[e].load() + move_y);
+        }
+    }
+
+    return max_step_span(levels[1]);
+}
+
+}
+}
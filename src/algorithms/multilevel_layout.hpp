@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <handlegraph/path_handle_graph.hpp>
+#include <handlegraph/util.hpp>
+
+/**
+ * \file multilevel_layout.hpp
+ *
+ * Multi-level initialization of the path-guided 2D SGD layout. The graph is coarsened by merging nodes that the paths
+ * traverse one after the other, the coarsest graph is laid out first, and each layout is carried down to the next
+ * finer graph and refined there.
+ */
+
+namespace odgi {
+namespace algorithms {
+
+using namespace handlegraph;
+
+/// Default number of nodes at which we stop coarsening.
+constexpr uint64_t multilevel_layout_default_coarsest = 1000;
+
+/// One level of the coarsening hierarchy: its nodes and the paths walking over them.
+struct layout_level_t {
+    uint64_t n_nodes = 0;
+    std::vector<uint64_t> parent;        // node of the next coarser level holding each node, if there is one
+    std::vector<uint64_t> length;        // bp of each node
+    std::vector<uint64_t> path_offsets;  // the steps of path p are [path_offsets[p], path_offsets[p + 1])
+    std::vector<uint64_t> steps;         // node of each step
+    std::vector<uint64_t> begin;         // bp range of each step in its path
+    std::vector<uint64_t> end;
+};
+
+/// The finest level, whose nodes are the nodes of the graph by rank, walked by the given paths.
+layout_level_t graph_layout_level(const PathHandleGraph& graph,
+                                  const std::vector<path_handle_t>& paths,
+                                  const uint64_t& nthreads);
+
+/// Merge pairs of nodes along the heaviest path adjacencies (a greedy heavy edge matching), setting the parents of the
+/// nodes of fine and returning the coarser level. Consecutive steps of a path on the same coarse node become one step.
+layout_level_t coarsen_layout_level(layout_level_t& fine, const uint64_t& nthreads);
+
+/// Move the node ends in X and Y (laid out as in path_linear_sgd_layout) by laying out the coarsening hierarchy of the
+/// graph, down to at most coarsest_node_count nodes, with iter_max SGD iterations per level. Returns the learning
+/// rate at which the path-guided SGD on the graph itself should start, or 0 if the graph could not be coarsened.
+double multilevel_path_sgd_layout(const PathHandleGraph& graph,
+                                  const std::vector<path_handle_t>& path_sgd_use_paths,
+                                  const uint64_t& coarsest_node_count,
+                                  const uint64_t& iter_max,
+                                  const double& eps,
+                                  const bool& repulsion,
+                                  const uint64_t& nthreads,
+                                  const bool& progress,
+                                  std::vector<std::atomic<double>>& X,
+                                  std::vector<std::atomic<double>>& Y);
+
+}
+}
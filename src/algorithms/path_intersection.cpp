@@ -0,0 +1,152 @@
+#include "path_intersection.hpp"
+#include "progress.hpp"
+#include <algorithm>
+#include <memory>
+
+namespace odgi {
+namespace algorithms {
+
+// pack an ordered pair of ids, a <= b
+inline uint64_t encode_pair(const uint32_t& a, const uint32_t& b) {
+    return ((uint64_t)a << 32) | (uint64_t)b;
+}
+
+void for_each_path_intersection(const PathHandleGraph& graph,
+                                const uint32_t& n_ids,
+                                const std::function<uint32_t(const path_handle_t&)>& get_id,
+                                const uint64_t& nthreads,
+                                const bool& progress,
+                                const std::function<void(const uint32_t&, const uint32_t&, const uint64_t&)>& func) {
+    const int n_buffers = std::max((int)nthreads, omp_get_max_threads());
+    const bool dense = (uint64_t)n_buffers * triangular_matrix_t::bytes(n_ids) <= path_intersection_dense_budget;
+
+    std::vector<triangular_matrix_t> dense_buffers;
+    std::vector<ska::flat_hash_map<uint64_t, uint64_t>> sparse_buffers;
+    if (dense) {
+        dense_buffers.reserve(n_buffers);
+        for (int t = 0; t < n_buffers; ++t) {
+            dense_buffers.emplace_back(n_ids);
+        }
+    } else {
+        sparse_buffers.resize(n_buffers);
+    }
+    // per-thread scratch space for the (id, length) pairs of a single node
+    std::vector<std::vector<std::pair<uint32_t, uint64_t>>> local_path_lengths(n_buffers);
+
+    std::unique_ptr<algorithms::progress_meter::ProgressMeter> progress_meter;
+    if (progress) {
+        progress_meter = std::make_unique<algorithms::progress_meter::ProgressMeter>(
+                graph.get_node_count(), "[odgi::algorithms::path_intersection] collecting path intersection lengths");
+    }
+
+    graph.for_each_handle(
+        [&](const handle_t& h) {
+            const int tid = omp_get_thread_num();
+            auto& local = local_path_lengths[tid];
+            local.clear();
+            const uint64_t l = graph.get_length(h);
+            graph.for_each_step_on_handle(
+                h,
+                [&](const step_handle_t& s) {
+                    local.emplace_back(get_id(graph.get_path_handle_of_step(s)), l);
+                });
+            // merge repeated visits of the same id, leaving the ids sorted
+            std::sort(local.begin(), local.end());
+            uint64_t k = 0;
+            for (uint64_t i = 0; i < local.size(); ++i) {
+                if (k > 0 && local[k - 1].first == local[i].first) {
+                    local[k - 1].second += local[i].second;
+                } else {
+                    local[k++] = local[i];
+                }
+            }
+            local.resize(k);
+            if (dense) {
+                auto& matrix = dense_buffers[tid];
+                for (uint64_t i = 0; i < local.size(); ++i) {
+                    // the row of a is contiguous for all b >= a
+                    uint64_t* row = &matrix.at(local[i].first, local[i].first);
+                    const uint32_t a = local[i].first;
+                    for (uint64_t j = i; j < local.size(); ++j) {
+                        row[local[j].first - a] += std::min(local[i].second, local[j].second);
+                    }
+                }
+            } else {
+                auto& map = sparse_buffers[tid];
+                for (uint64_t i = 0; i < local.size(); ++i) {
+                    for (uint64_t j = i; j < local.size(); ++j) {
+                        map[encode_pair(local[i].first, local[j].first)] += std::min(local[i].second, local[j].second);
+                    }
+                }
+            }
+            if (progress) {
+                progress_meter->increment(1);
+            }
+        }, true);
+
+    if (progress) {
+        progress_meter->finish();
+    }
+
+    if (dense) {
+        // reduce into the first matrix, tile by tile
+        auto& result = dense_buffers.front();
+        const uint64_t size = result.data.size();
+        const uint64_t tile = 1 << 14;
+#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+        for (uint64_t begin = 0; begin < size; begin += tile) {
+            const uint64_t end = std::min(begin + tile, size);
+            for (int t = 1; t < n_buffers; ++t) {
+                const uint64_t* src = dense_buffers[t].data.data();
+                uint64_t* dst = result.data.data();
+                for (uint64_t i = begin; i < end; ++i) {
+                    dst[i] += src[i];
+                }
+            }
+        }
+        dense_buffers.resize(1);
+        for (uint32_t a = 0; a < n_ids; ++a) {
+            for (uint32_t b = 0; b < n_ids; ++b) {
+                const uint64_t& intersection = a <= b ? result.at(a, b) : result.at(b, a);
+                if (intersection) {
+                    func(a, b, intersection);
+                }
+            }
+        }
+    } else {
+        // shard every thread's map by key, then reduce each shard on its own
+        const uint64_t n_shards = n_buffers;
+        std::vector<std::vector<std::vector<std::pair<uint64_t, uint64_t>>>> bins(
+                n_buffers, std::vector<std::vector<std::pair<uint64_t, uint64_t>>>(n_shards));
+#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+        for (int t = 0; t < n_buffers; ++t) {
+            for (auto& p : sparse_buffers[t]) {
+                bins[t][std::hash<uint64_t>()(p.first) % n_shards].push_back(p);
+            }
+            ska::flat_hash_map<uint64_t, uint64_t>().swap(sparse_buffers[t]);
+        }
+        std::vector<ska::flat_hash_map<uint64_t, uint64_t>> shards(n_shards);
+#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+        for (uint64_t s = 0; s < n_shards; ++s) {
+            for (int t = 0; t < n_buffers; ++t) {
+                for (auto& p : bins[t][s]) {
+                    shards[s][p.first] += p.second;
+                }
+                std::vector<std::pair<uint64_t, uint64_t>>().swap(bins[t][s]);
+            }
+        }
+        for (auto& shard : shards) {
+            for (auto& p : shard) {
+                const uint32_t a = p.first >> 32;
+                const uint32_t b = p.first & 0x00000000FFFFFFFF;
+                func(a, b, p.second);
+                if (a != b) {
+                    func(b, a, p.second);
+                }
+            }
+        }
+    }
+}
+
+}
+}
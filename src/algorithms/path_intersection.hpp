@@ -0,0 +1,59 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <omp.h>
+#include <handlegraph/types.hpp>
+#include <handlegraph/util.hpp>
+#include <handlegraph/path_handle_graph.hpp>
+#include "hash_map.hpp"
+
+/**
+ * \file path_intersection.hpp
+ *
+ * Accumulates the pairwise intersection length (in bp) of paths, or groups of paths, over all nodes of a graph.
+ */
+
+namespace odgi {
+namespace algorithms {
+
+using namespace handlegraph;
+
+/// Above this many bytes for the per-thread triangular matrices we fall back to per-thread sparse accumulation.
+constexpr uint64_t path_intersection_dense_budget = 1ULL << 30;
+
+/// Upper-triangular matrix of pairwise intersection lengths, stored row-major without the lower half.
+class triangular_matrix_t {
+public:
+    triangular_matrix_t(const uint32_t& n) : n(n), data((uint64_t)n * (n + 1) / 2, 0) { }
+    /// index of (a, b) with a <= b
+    inline uint64_t index(const uint32_t& a, const uint32_t& b) const {
+        return (uint64_t)a * (2 * (uint64_t)n - a + 1) / 2 + (b - a);
+    }
+    inline uint64_t& at(const uint32_t& a, const uint32_t& b) {
+        return data[index(a, b)];
+    }
+    inline const uint64_t& at(const uint32_t& a, const uint32_t& b) const {
+        return data[index(a, b)];
+    }
+    static uint64_t bytes(const uint32_t& n) {
+        return (uint64_t)n * (n + 1) / 2 * sizeof(uint64_t);
+    }
+    uint32_t n;
+    std::vector<uint64_t> data;
+};
+
+/// Collect the intersection lengths of all pairs of ids (as given by get_id for each path) that share at least one node,
+/// calling func(a, b, intersection) for both (a, b) and (b, a), and once for (a, a).
+/// Each thread accumulates into its own dense triangular matrix when these fit in path_intersection_dense_budget,
+/// and into its own sparse map otherwise; the thread-local results are reduced in parallel at the end.
+void for_each_path_intersection(const PathHandleGraph& graph,
+                                const uint32_t& n_ids,
+                                const std::function<uint32_t(const path_handle_t&)>& get_id,
+                                const uint64_t& nthreads,
+                                const bool& progress,
+                                const std::function<void(const uint32_t&, const uint32_t&, const uint64_t&)>& func);
+
+}
+}
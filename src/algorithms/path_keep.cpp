@@ -8,12 +8,12 @@ void keep_paths(const graph_t& graph, graph_t& into, const ska::flat_hash_set<pa
         into.create_handle(graph.get_sequence(h), graph.get_id(h));
     });
     graph.for_each_handle([&](const handle_t& h) {
-        graph.follow_edges(h, false, [&](const handle_t& t) {
+        graph.follow_edges_fast(h, false, [&](const handle_t& t) {
             into.create_edge(into.get_handle(graph.get_id(h), graph.get_is_reverse(h)),
                              into.get_handle(graph.get_id(t), graph.get_is_reverse(t)));
         });
         auto r = graph.flip(h);
-        graph.follow_edges(r, false, [&](const handle_t& t) {
+        graph.follow_edges_fast(r, false, [&](const handle_t& t) {
             into.create_edge(into.get_handle(graph.get_id(r), graph.get_is_reverse(r)),
                              into.get_handle(graph.get_id(t), graph.get_is_reverse(t)));
         });
@@ -550,20 +550,30 @@ namespace odgi {
             std::cerr << "node count: " << graph.get_node_count() << std::endl;
 #endif
             // refine order by weakly connected components
-            std::vector<ska::flat_hash_set<handlegraph::nid_t>> weak_components = algorithms::weakly_connected_components(
-                    &graph);
+            uint64_t n_components = 0;
+            std::vector<uint64_t> weak_components_map = algorithms::weakly_connected_component_ids(
+                    graph, n_components, nthreads);
 #ifdef debug_components
-            std::cerr << "components count: " << weak_components.size() << std::endl;
+            std::cerr << "components count: " << n_components << std::endl;
 #endif
-            std::vector<std::pair<double, uint64_t>> weak_component_order;
-            for (int i = 0; i < weak_components.size(); i++) {
-                auto &weak_component = weak_components[i];
-                uint64_t id_sum = 0;
-                for (auto node_id : weak_component) {
-                    id_sum += node_id;
+            std::vector<uint64_t> id_sum(n_components, 0);
+            std::vector<uint64_t> component_size(n_components, 0);
+            const nid_t shift = graph.min_node_id();
+            for (uint64_t i = 0; i < weak_components_map.size(); ++i) {
+                const uint64_t c = weak_components_map[i];
+                if (c != algorithms::no_weak_component) {
+                    id_sum[c] += i + shift;
+                    ++component_size[c];
                 }
-                double avg_id = id_sum / (double) weak_component.size();
+            }
+            std::vector<std::pair<double, uint64_t>> weak_component_order;
+            for (uint64_t i = 0; i < n_components; i++) {
+                double avg_id = id_sum[i] / (double) component_size[i];
                 weak_component_order.push_back(std::make_pair(avg_id, i));
+#ifdef debug_components
+                std::cerr << "weak_component.size(): " << component_size[i] << std::endl;
+                std::cerr << "component_index: " << i << std::endl;
+#endif
             }
             std::sort(weak_component_order.begin(), weak_component_order.end());
             std::vector<uint64_t> weak_component_id; // maps rank to "id" based on the orignial sorted order
@@ -572,21 +582,12 @@ namespace odgi {
             for (auto &component_order : weak_component_order) {
                 weak_component_id[component_order.second] = component_id++;
             }
-            std::vector<uint64_t> weak_components_map;
-            weak_components_map.resize(graph.get_node_count());
-            // reserve the space we need
-            for (int i = 0; i < weak_components.size(); i++) {
-                auto &weak_component = weak_components[i];
-                // store for each node identifier to component start index
-                for (auto node_id : weak_component) {
-                    weak_components_map[node_id - 1] = weak_component_id[i];
+            // store for each node rank its component in the sorted order
+            for (auto &c : weak_components_map) {
+                if (c != algorithms::no_weak_component) {
+                    c = weak_component_id[c];
                 }
-#ifdef debug_components
-                std::cerr << "weak_component.size(): " << weak_component.size() << std::endl;
-                std::cerr << "component_index: " << i << std::endl;
-#endif
             }
-            weak_components_map.clear();
             if (snapshot) {
                 for (int j = 0; j < snapshots.size(); j++) {
                     std::string snapshot_file_name = snapshots[j];
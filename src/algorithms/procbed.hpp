@@ -7,12 +7,14 @@
 #include <algorithm>
 #include <random>
 #include <fstream>
+#include <sstream>
 #include <omp.h>
 #include "hash_map.hpp"
 #include "progress.hpp"
 #include "position.hpp"
 #include "split.hpp"
 #include "IITree.h"
+#include "bed_intervals.hpp"
 #include <handlegraph/types.hpp>
 #include <handlegraph/iteratee.hpp>
 #include <handlegraph/util.hpp>
@@ -9,27 +9,32 @@ using namespace handlegraph;
 std::vector<double> sgd_layout(const HandleGraph& graph, uint64_t pivots, uint64_t t_max, double eps, double x_padding) {
     std::vector<double> layout(graph.get_node_count()*2);
     double max_x = 0;
-    auto weak_components = algorithms::weakly_connected_components(&graph);
-    for (auto& weak_component : weak_components) {
-        std::vector<handlegraph::nid_t> component_ids;
-        ska::flat_hash_map<handlegraph::nid_t, uint64_t> local_id;
-        for (auto& id : weak_component) {
-            component_ids.push_back(id);
+    uint64_t n_components = 0;
+    const std::vector<uint64_t> component_of = algorithms::weakly_connected_component_ids(graph, n_components);
+    std::vector<handlegraph::nid_t> members;
+    std::vector<uint64_t> offsets;
+    algorithms::weakly_connected_component_members(graph, component_of, n_components, members, offsets);
+    const nid_t shift = graph.min_node_id();
+    // the members of each component are sorted, so a node's local id is its offset in the component
+    std::vector<uint64_t> local_id(component_of.size());
+    for (uint64_t c = 0; c < n_components; ++c) {
+        for (uint64_t k = offsets[c]; k < offsets[c + 1]; ++k) {
+            local_id[members[k] - shift] = k - offsets[c];
         }
-        std::sort(component_ids.begin(), component_ids.end());
-        for (uint64_t i = 0; i < component_ids.size(); ++i) {
-            local_id[component_ids[i]] = i;
-        }
-        // convert to input format for SGD
-        std::vector<uint64_t> I, J;
-        graph.for_each_edge([&](const edge_t& e) {
-                if (weak_component.count(graph.get_id(e.first))
-                    && weak_component.count(graph.get_id(e.first))) {
-                    I.push_back(local_id[graph.get_id(e.first)]);
-                    J.push_back(local_id[graph.get_id(e.second)]);
-                }
-            });
-        uint64_t n = weak_component.size();
+    }
+    // convert to input format for SGD, bucketing the edges by component in a single pass
+    std::vector<std::vector<uint64_t>> component_I(n_components), component_J(n_components);
+    graph.for_each_edge([&](const edge_t& e) {
+            const uint64_t a = graph.get_id(e.first) - shift;
+            const uint64_t b = graph.get_id(e.second) - shift;
+            component_I[component_of[a]].push_back(local_id[a]);
+            component_J[component_of[a]].push_back(local_id[b]);
+        });
+    for (uint64_t c = 0; c < n_components; ++c) {
+        const auto component_ids = members.begin() + offsets[c];
+        auto& I = component_I[c];
+        auto& J = component_J[c];
+        uint64_t n = offsets[c + 1] - offsets[c];
         std::vector<double> X(2*n);
         std::random_device dev;
         // todo, seed with graph topology/contents to get a more stable result
@@ -57,6 +62,8 @@ std::vector<double> sgd_layout(const HandleGraph& graph, uint64_t pivots, uint64
             max_x = std::max(X[i], max_x);
         }
         max_x += x_padding;
+        std::vector<uint64_t>().swap(I);
+        std::vector<uint64_t>().swap(J);
     }
     // all the weakly connected component layouts have been merged here
     /*
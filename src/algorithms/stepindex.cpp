@@ -1,5 +1,6 @@
 #include "stepindex.hpp"
 #include "progress.hpp"
+#include <algorithm>
 
 namespace odgi {
 namespace algorithms {
@@ -16,36 +17,45 @@ step_index_t::step_index_t(const PathHandleGraph& graph,
                            const bool progress,
 						   const uint64_t& sample_rate) {
 	this->sample_rate = sample_rate;
+	auto sampled = [&](const step_handle_t& step) {
+		return sample_rate == 0 || 0 == utils::modulo(graph.get_id(graph.get_handle_of_step(step)), sample_rate);
+	};
 
-    // iterate through the paths, recording steps in the structure we'll use to build the mphf
-    std::vector<step_handle_t> steps;
+    // iterate through the paths, each recording its own steps and their positions, so no locking is needed
+    std::vector<std::vector<step_handle_t>> path_steps(paths.size());
+    std::vector<std::vector<uint64_t>> path_positions(paths.size());
 	std::unique_ptr<algorithms::progress_meter::ProgressMeter> collecting_steps_progress_meter;
 	if (progress) {
 		collecting_steps_progress_meter = std::make_unique<algorithms::progress_meter::ProgressMeter>(
 				paths.size(), "[odgi::algorithms::stepindex] Collecting Steps Progress:");
 	}
-	path_len.resize(paths.size());
-#pragma omp parallel for schedule(dynamic,1)
-    for (auto& path : paths) {
-        std::vector<step_handle_t> my_steps;
+	uint64_t max_path_rank = 0;
+	for (auto& path : paths) {
+		max_path_rank = std::max(max_path_rank, (uint64_t)as_integer(path));
+	}
+	path_len.resize(std::max(max_path_rank, (uint64_t)paths.size()));
+#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+    for (uint64_t i = 0; i < paths.size(); ++i) {
+        auto& path = paths[i];
+        auto& my_steps = path_steps[i];
+        auto& my_positions = path_positions[i];
 		uint64_t path_length = 0;
         graph.for_each_step_in_path(
             path, [&](const step_handle_t& step) {
-				path_length += graph.get_length(graph.get_handle_of_step(step));
 				// sampling
-				if (sample_rate == 0 || 0 == utils::modulo(graph.get_id(graph.get_handle_of_step(step)), sample_rate)) {
+				if (sampled(step)) {
 					my_steps.push_back(step);
+					my_positions.push_back(path_length);
 				}
+				path_length += graph.get_length(graph.get_handle_of_step(step));
 			});
 		// sampling
-		if (sample_rate == 0 || 0 == utils::modulo(graph.get_id(graph.get_handle_of_step(graph.path_end(path))), sample_rate)) {
+		if (sampled(graph.path_end(path))) {
 			my_steps.push_back(graph.path_end(path));
+			my_positions.push_back(path_length);
 		}
-
-#pragma omp critical (path_len)
+		// each path has its own entry
 		path_len[as_integer(path) - 1] = path_length;
-#pragma omp critical (steps_collect)
-        steps.insert(steps.end(), my_steps.begin(), my_steps.end());
         if(progress) {
         	collecting_steps_progress_meter->increment(1);
         }
@@ -53,8 +63,22 @@ step_index_t::step_index_t(const PathHandleGraph& graph,
 	if (progress) {
 		collecting_steps_progress_meter->finish();
 	}
-    // sort the steps
-    ips4o::parallel::sort(steps.begin(), steps.end(), std::less<>(), nthreads);
+
+    // lay out the steps of all paths one after the other in dense arrays
+    std::vector<uint64_t> offsets(paths.size() + 1, 0);
+    for (uint64_t i = 0; i < paths.size(); ++i) {
+        offsets[i + 1] = offsets[i] + path_steps[i].size();
+    }
+    std::vector<step_handle_t> steps(offsets.back());
+    std::vector<uint64_t> positions(offsets.back());
+#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+    for (uint64_t i = 0; i < paths.size(); ++i) {
+        std::copy(path_steps[i].begin(), path_steps[i].end(), steps.begin() + offsets[i]);
+        std::copy(path_positions[i].begin(), path_positions[i].end(), positions.begin() + offsets[i]);
+        std::vector<step_handle_t>().swap(path_steps[i]);
+        std::vector<uint64_t>().swap(path_positions[i]);
+    }
+
     // build the hash function (quietly)
     step_mphf = new boophf_step_t(steps.size(), steps, nthreads, 2.0, false, false);
     // use the hash function to record the step positions
@@ -64,21 +88,11 @@ step_index_t::step_index_t(const PathHandleGraph& graph,
 		building_progress_meter = std::make_unique<algorithms::progress_meter::ProgressMeter>(
 				paths.size(), "[odgi::algorithms::stepindex] Building Progress:");
 	}
-#pragma omp parallel for schedule(dynamic,1)
-    for (auto& path : paths) {
-        uint64_t offset = 0;
-        graph.for_each_step_in_path(
-            path, [&](const step_handle_t& step) {
-				// sampling
-				if (sample_rate == 0 || 0 == utils::modulo(graph.get_id(graph.get_handle_of_step(step)), sample_rate)) {
-					pos[step_mphf->lookup(step)] = offset;
-				}
-				offset += graph.get_length(graph.get_handle_of_step(step));
-				});
-		// sampling
-		if (sample_rate == 0 || 0 == utils::modulo(graph.get_id(graph.get_handle_of_step(graph.path_end(path))), sample_rate)) {
-			pos[step_mphf->lookup(graph.path_end(path))] = offset;
-		}
+#pragma omp parallel for schedule(dynamic,1) num_threads(nthreads)
+    for (uint64_t i = 0; i < paths.size(); ++i) {
+        for (uint64_t j = offsets[i]; j < offsets[i + 1]; ++j) {
+            pos[step_mphf->lookup(steps[j])] = positions[j];
+        }
         if (progress) {
         	building_progress_meter->increment(1);
         }
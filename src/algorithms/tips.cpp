@@ -53,7 +53,7 @@ namespace odgi {
 					// did we already hit the given reference path?
 					if (target_handles[number_bool_packing::unpack_number(cur_h)]) {
 						std::vector<step_handle_t> target_step_handles;
-						graph.for_each_step_on_handle(
+						graph.for_each_step_on_handle_fast(
 								cur_h,
 								[&](const step_handle_t& s) {
 									/// we can do these expensive iterations here, because we only have to do it once for each walk
@@ -256,13 +256,12 @@ namespace odgi {
             return combined;
         }
 
-        bool unchop(handlegraph::MutablePathDeletableHandleGraph &graph) {
-            return unchop(graph, 1, false);
-        }
-
-        bool unchop(handlegraph::MutablePathDeletableHandleGraph &graph,
-                    const uint64_t &nthreads,
-                    const bool &show_info) {
+        /// Unchop with the given way of merging the runs of handles into single nodes, which returns the
+        /// new handle of each run, or its handles if it could not be merged.
+        static bool unchop(handlegraph::MutablePathDeletableHandleGraph &graph,
+                           const uint64_t &nthreads,
+                           const bool &show_info,
+                           const std::function<std::vector<std::vector<handle_t>>(const std::vector<std::vector<handle_t>>&)> &merge_runs) {
 #ifdef debug
             std::cerr << "Running unchop" << std::endl;
 #endif
@@ -311,7 +310,8 @@ namespace odgi {
                     });
 
             uint64_t num_node_unchopped = 0;
-            uint64_t num_new_nodes = 0;
+            std::vector<std::vector<handle_t>> runs;
+            std::vector<double> run_ranks;
             for (auto &comp : components) {
 #ifdef debug
                 std::cerr << "Unchop " << comp.size() << " nodes together" << std::endl;
@@ -322,18 +322,29 @@ namespace odgi {
                     for (auto &handle : comp) {
                         rank_sum += node_rank[graph.get_id(handle)];
                     }
-                    double rank_v = rank_sum / comp.size();
-                    handle_t n = concat_nodes(graph, comp);
-                    ordered_handles.push_back(std::make_pair(rank_v, n));
-                    //node_order.push_back(graph.get_id(n));
+                    run_ranks.push_back(rank_sum / comp.size());
                     num_node_unchopped += comp.size();
-                    num_new_nodes++;
+                    runs.push_back(std::move(comp));
                 } else {
                     for (auto &c : comp) {
                         ordered_handles.push_back(std::make_pair(node_rank[graph.get_id(c)], c));
                     }
                 }
             }
+            uint64_t num_new_nodes = 0;
+            const std::vector<std::vector<handle_t>> merged = merge_runs(runs);
+            for (uint64_t i = 0; i < merged.size(); ++i) {
+                if (merged[i].size() == 1) {
+                    ordered_handles.push_back(std::make_pair(run_ranks[i], merged[i].front()));
+                    ++num_new_nodes;
+                } else {
+                    // the run was left as it is
+                    for (auto &h : merged[i]) {
+                        ordered_handles.push_back(std::make_pair(node_rank[graph.get_id(h)], h));
+                    }
+                    num_node_unchopped -= merged[i].size();
+                }
+            }
 
             // todo try sorting again
 
@@ -379,5 +390,37 @@ namespace odgi {
 
             return ok.load();
         }
+
+        bool unchop(handlegraph::MutablePathDeletableHandleGraph &graph) {
+            return unchop(graph, 1, false);
+        }
+
+        bool unchop(handlegraph::MutablePathDeletableHandleGraph &graph,
+                    const uint64_t &nthreads,
+                    const bool &show_info) {
+            return unchop(graph, nthreads, show_info,
+                          [&](const std::vector<std::vector<handle_t>> &runs) {
+                              std::vector<std::vector<handle_t>> merged;
+                              merged.reserve(runs.size());
+                              for (auto &run : runs) {
+                                  merged.push_back({concat_nodes(graph, run)});
+                              }
+                              return merged;
+                          });
+        }
+
+        bool unchop(graph_t &graph) {
+            return unchop(graph, 1, false);
+        }
+
+        bool unchop(graph_t &graph,
+                    const uint64_t &nthreads,
+                    const bool &show_info) {
+            graph.set_number_of_threads(nthreads);
+            return unchop(graph, nthreads, show_info,
+                          [&](const std::vector<std::vector<handle_t>> &runs) {
+                              return graph.combine_handle_runs(runs);
+                          });
+        }
     }
 }
@@ -10,9 +10,11 @@
 #include <iostream>
 #include <sstream>
 #include <atomic>
+#include <functional>
 
 #include "ips4o.hpp"
 #include "simple_components.hpp"
+#include "odgi.hpp"
 
 namespace odgi {
 namespace algorithms {
@@ -38,6 +40,24 @@ bool unchop(handlegraph::MutablePathDeletableHandleGraph& graph,
             const uint64_t& nthreads,
             const bool& show_info);
 
+/**
+ * Unchop by gluing abutting handles with just a single edge between them and
+ * compatible path steps together, merging all the runs at once in parallel.
+ * @param graph
+ */
+bool unchop(graph_t& graph);
+
+/**
+ * Unchop by gluing abutting handles with just a single edge between them and
+ * compatible path steps together, merging all the runs at once in parallel.
+ * @param graph
+ * @param nthreads
+ * @param show_info
+ */
+bool unchop(graph_t& graph,
+            const uint64_t& nthreads,
+            const bool& show_info);
+
 //std::vector<std::deque<handle_t>> simple_components(PathHandleGraph* graph, int min_size = 1, false);
 
 handle_t concat_nodes(handlegraph::MutablePathDeletableHandleGraph& graph, const std::vector<handle_t>& nodes);
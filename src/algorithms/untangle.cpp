@@ -184,20 +184,19 @@ std::vector<step_handle_t> merge_cuts(
 void self_dotplot(
     const PathHandleGraph& graph,
     const path_handle_t& path) {
-    auto step_pos = make_step_index(graph, { path }, 1);
+    step_index_t step_pos(graph, { path }, 1, false, 0);
     auto path_name = graph.get_path_name(path);
     std::cout << "name\tfrom\tto" << std::endl;
+    uint64_t curr_pos = 0;
     graph.for_each_step_in_path(
         path,
         [&](const step_handle_t& step) {
-            // TODO this is given by the walk, no need for a hash table lookup
-            const auto& curr_pos = step_pos.find(step)->second;
             handle_t handle = graph.get_handle_of_step(step);
             graph.for_each_step_on_handle(
                 handle,
                 [&](const step_handle_t& s) {
                     if (graph.get_path_handle_of_step(s) == path) {
-                        const auto& other_pos = step_pos.find(s)->second;
+                        const auto other_pos = step_pos.get_position(s, graph);
                         std::cout << path_name << "\t"
                                   << curr_pos << "\t"
                                   << other_pos << std::endl;
@@ -210,44 +209,10 @@ void self_dotplot(
                         */
                     }
                 });
+            curr_pos += graph.get_length(handle);
         });
 }
 
-ska::flat_hash_map<step_handle_t, uint64_t> make_step_index(
-    const PathHandleGraph& graph,
-    const std::vector<path_handle_t>& paths,
-    const size_t& num_threads) {
-    ska::flat_hash_map<step_handle_t, uint64_t> step_pos;
-#pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
-    for (auto& path : paths) {
-        uint64_t pos = 0;
-        graph.for_each_step_in_path(
-            path,
-            [&](const step_handle_t& step) {
-#pragma omp critical (step_pos)
-                step_pos[step] = pos;
-                handle_t handle = graph.get_handle_of_step(step);
-                pos += graph.get_length(handle);
-            });
-#pragma omp critical (step_pos)
-        step_pos[graph.path_end(path)] = pos; // record the end position
-    }
-    return step_pos;
-}
-
-void show_steps(
-    const PathHandleGraph& graph,
-    const ska::flat_hash_map<step_handle_t, uint64_t>& steps) {
-    for (auto& pos : steps) {
-        auto h = graph.get_handle_of_step(pos.first);
-        auto p = graph.get_path_handle_of_step(pos.first);
-        auto name = graph.get_path_name(p);
-        auto id = graph.get_id(h);
-        auto rev = graph.get_is_reverse(h);
-        std::cerr << name << " " << id << (rev?"-":"+") << " " << pos.second << std::endl;
-    }
-}
-
 // compute the reference segmentations
 // and map them onto the graph using a static multiset index structure based on two arrays
 // we'll build up a big vector of node -> path segment pairings
@@ -88,11 +88,6 @@ void self_dotplot(
     const PathHandleGraph& graph,
     const path_handle_t& path);
 
-ska::flat_hash_map<step_handle_t, uint64_t> make_step_index(
-    const PathHandleGraph& graph,
-    const std::vector<path_handle_t>& paths,
-    const size_t& num_threads);
-
 double self_mean_coverage(
     const PathHandleGraph& graph,
     const path_step_index_t& self_index,
@@ -5,58 +5,109 @@ namespace algorithms {
 
 using namespace handlegraph;
 
-std::vector<ska::flat_hash_set<handlegraph::nid_t>> weakly_connected_components(const HandleGraph* graph) {
-    std::vector<ska::flat_hash_set<handlegraph::nid_t>> to_return;
-    
-    // This only holds locally forward handles
-    ska::flat_hash_set<handle_t> traversed;
-    
-    graph->for_each_handle([&](const handle_t& handle) {
-        
-        // Only think about it in the forward orientation
-        auto forward = graph->forward(handle);
-        
-        if (traversed.count(forward)) {
-            // Already have this node, so don't start a search from it.
-            return;
-        }
-        
-        // The stack only holds locally forward handles
-        std::vector<handle_t> stack{forward};
-        to_return.emplace_back();
-        while (!stack.empty()) {
-            handle_t here = stack.back();
-            stack.pop_back();
-            
-            traversed.insert(here);
-            to_return.back().insert(graph->get_id(here));
-            
-            // We have a function to handle all connected handles
-            auto handle_other = [&](const handle_t& other) {
-                // Again, make it forward
-                auto other_forward = graph->forward(other);
-                
-                if (!traversed.count(other_forward)) {
-                    stack.push_back(other_forward);
+std::vector<uint64_t> weakly_connected_component_ids(const HandleGraph& graph,
+                                                     uint64_t& n_components,
+                                                     const uint64_t& nthreads) {
+    n_components = 0;
+    if (graph.get_node_count() == 0) {
+        return {};
+    }
+    const nid_t shift = graph.min_node_id();
+    const uint64_t n = graph.max_node_id() - shift + 1;
+    std::vector<uint64_t> component_ids(n, no_weak_component);
+    {
+        std::vector<std::atomic<DisjointSets::Aint>> dset_data(n);
+        auto dset = DisjointSets(dset_data.data(), dset_data.size());
+
+        // each edge is seen from both of its ends, so we only unite towards the larger rank
+#pragma omp parallel for schedule(dynamic, 4096) num_threads(nthreads)
+        for (uint64_t i = 0; i < n; ++i) {
+            if (!graph.has_node(i + shift)) {
+                continue;
+            }
+            const handle_t h = graph.get_handle(i + shift);
+            auto unite_other = [&](const handle_t& other) {
+                const uint64_t j = graph.get_id(other) - shift;
+                if (j > i) {
+                    dset.unite(i, j);
                 }
             };
-            
-            // Look at edges in both directions
-            graph->follow_edges(here, false, handle_other);
-            graph->follow_edges(here, true, handle_other);
-            
+            graph.follow_edges(h, false, unite_other);
+            graph.follow_edges(h, true, unite_other);
         }
-    });
+
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+        for (uint64_t i = 0; i < n; ++i) {
+            if (graph.has_node(i + shift)) {
+                component_ids[i] = dset.find(i);
+            }
+        }
+    }
+
+    // relabel the roots densely, in order of the first member of each set
+    std::vector<uint64_t> root_label(n, no_weak_component);
+    for (auto& c : component_ids) {
+        if (c != no_weak_component) {
+            if (root_label[c] == no_weak_component) {
+                root_label[c] = n_components++;
+            }
+            c = root_label[c];
+        }
+    }
+    return component_ids;
+}
+
+void weakly_connected_component_members(const HandleGraph& graph,
+                                        const std::vector<uint64_t>& component_ids,
+                                        const uint64_t& n_components,
+                                        std::vector<handlegraph::nid_t>& members,
+                                        std::vector<uint64_t>& offsets) {
+    offsets.assign(n_components + 1, 0);
+    for (auto& c : component_ids) {
+        if (c != no_weak_component) {
+            ++offsets[c + 1];
+        }
+    }
+    for (uint64_t c = 0; c < n_components; ++c) {
+        offsets[c + 1] += offsets[c];
+    }
+    members.resize(offsets.back());
+    std::vector<uint64_t> next(offsets.begin(), offsets.end() - 1);
+    const nid_t shift = graph.min_node_id();
+    for (uint64_t i = 0; i < component_ids.size(); ++i) {
+        if (component_ids[i] != no_weak_component) {
+            members[next[component_ids[i]]++] = i + shift;
+        }
+    }
+}
+
+std::vector<ska::flat_hash_set<handlegraph::nid_t>> weakly_connected_components(const HandleGraph* graph,
+                                                                               const uint64_t& nthreads) {
+    uint64_t n_components = 0;
+    std::vector<uint64_t> component_ids = weakly_connected_component_ids(*graph, n_components, nthreads);
+    std::vector<handlegraph::nid_t> members;
+    std::vector<uint64_t> offsets;
+    weakly_connected_component_members(*graph, component_ids, n_components, members, offsets);
+    std::vector<ska::flat_hash_set<handlegraph::nid_t>> to_return(n_components);
+    for (uint64_t c = 0; c < n_components; ++c) {
+        to_return[c].insert(members.begin() + offsets[c], members.begin() + offsets[c + 1]);
+    }
     return to_return;
 }
 
-std::vector<std::vector<handlegraph::handle_t>> weakly_connected_component_vectors(const HandleGraph* graph) {
-    std::vector<std::vector<handlegraph::handle_t>> components;
-    for (auto& component : weakly_connected_components(graph)) {
-        components.emplace_back();
-        auto& v = components.back();
-        for (auto& id : component) {
-            v.push_back(graph->get_handle(id));
+std::vector<std::vector<handlegraph::handle_t>> weakly_connected_component_vectors(const HandleGraph* graph,
+                                                                                  const uint64_t& nthreads) {
+    uint64_t n_components = 0;
+    std::vector<uint64_t> component_ids = weakly_connected_component_ids(*graph, n_components, nthreads);
+    std::vector<handlegraph::nid_t> members;
+    std::vector<uint64_t> offsets;
+    weakly_connected_component_members(*graph, component_ids, n_components, members, offsets);
+    std::vector<std::vector<handlegraph::handle_t>> components(n_components);
+    for (uint64_t c = 0; c < n_components; ++c) {
+        auto& v = components[c];
+        v.reserve(offsets[c + 1] - offsets[c]);
+        for (uint64_t k = offsets[c]; k < offsets[c + 1]; ++k) {
+            v.push_back(graph->get_handle(members[k]));
         }
         std::sort(v.begin(), v.end(),
                   [](const handle_t& a,
@@ -9,23 +9,46 @@
 #include <handlegraph/handle_graph.hpp>
 #include <handlegraph/util.hpp>
 #include "hash_map.hpp"
+#include "dset64.hpp"
 #include <vector>
 #include <algorithm>
+#include <limits>
+#include <omp.h>
 
 namespace odgi {
 namespace algorithms {
 
 using namespace handlegraph;
 
+/// Marks node ranks without a node in graphs whose IDs are not compacted.
+constexpr uint64_t no_weak_component = std::numeric_limits<uint64_t>::max();
+
+/// Returns the weakly connected component of every node, indexed by node rank
+/// (ID - min_node_id()), and sets n_components. Components are found with a
+/// parallel sweep over the edges into a lock-free union-find, and are numbered
+/// in order of their smallest node ID. Ranks without a node get no_weak_component.
+std::vector<uint64_t> weakly_connected_component_ids(const HandleGraph& graph,
+                                                     uint64_t& n_components,
+                                                     const uint64_t& nthreads = 1);
+
+/// Groups the node IDs of each component, in ascending order, so that the members of
+/// component c are members[offsets[c]] to members[offsets[c+1]-1].
+void weakly_connected_component_members(const HandleGraph& graph,
+                                        const std::vector<uint64_t>& component_ids,
+                                        const uint64_t& n_components,
+                                        std::vector<handlegraph::nid_t>& members,
+                                        std::vector<uint64_t>& offsets);
+
 /// Returns sets of IDs defining components that are connected by any series
-/// of nodes and edges, even if it is not a valid bidirected walk. TODO: It
-/// might make sense to have a handle-returning version, but the consumers of
-/// weakly connected components right now want IDs, and membership in a weakly
-/// connected component is orientation-independent.
-std::vector<ska::flat_hash_set<handlegraph::nid_t>> weakly_connected_components(const HandleGraph* graph);
+/// of nodes and edges, even if it is not a valid bidirected walk. Membership
+/// in a weakly connected component is orientation-independent. Prefer
+/// weakly_connected_component_ids on large graphs, as the sets are costly.
+std::vector<ska::flat_hash_set<handlegraph::nid_t>> weakly_connected_components(const HandleGraph* graph,
+                                                                               const uint64_t& nthreads = 1);
 
 /// Returns a vector of handles, one for each component, which can be easier to use in some cases
-std::vector<std::vector<handlegraph::handle_t>> weakly_connected_component_vectors(const HandleGraph* graph);
+std::vector<std::vector<handlegraph::handle_t>> weakly_connected_component_vectors(const HandleGraph* graph,
+                                                                                  const uint64_t& nthreads = 1);
 
 /// Return pairs of weakly connected component ID sets and the handles that are
 /// their tips, oriented inward. If a node is both a head and a tail, it will
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+
+/**
+ * \file atomic_pointer_table.hpp
+ *
+ * A dense table of pointers indexed by small integers, which can grow while it is read and written concurrently.
+ */
+
+namespace odgi {
+
+/// Entries are kept in segments of doubling size that are allocated on first use and never moved, so a lookup is two
+/// loads and growing the table does not stop readers. Unset entries are nullptr.
+template<typename T>
+class atomic_pointer_table_t {
+public:
+    atomic_pointer_table_t() {
+        for (uint64_t s = 0; s < n_segments; ++s) {
+            segments[s].store(nullptr);
+        }
+    }
+    ~atomic_pointer_table_t() { clear(); }
+    atomic_pointer_table_t(const atomic_pointer_table_t& other) = delete;
+    atomic_pointer_table_t& operator=(const atomic_pointer_table_t& other) = delete;
+
+    inline T* get(const uint64_t& i) const {
+        uint64_t s, o;
+        locate(i, s, o);
+        const std::atomic<T*>* segment = segments[s].load(std::memory_order_acquire);
+        return segment ? segment[o].load(std::memory_order_acquire) : nullptr;
+    }
+
+    inline void set(const uint64_t& i, T* p) {
+        uint64_t s, o;
+        locate(i, s, o);
+        std::atomic<T*>* segment = segments[s].load(std::memory_order_acquire);
+        if (segment == nullptr) {
+            // value-initialized, so all entries are nullptr
+            std::atomic<T*>* fresh = new std::atomic<T*>[segment_size(s)]();
+            if (segments[s].compare_exchange_strong(segment, fresh, std::memory_order_acq_rel)) {
+                segment = fresh;
+            } else {
+                // another thread allocated the segment first, and segment now points to it
+                delete[] fresh;
+            }
+        }
+        segment[o].store(p, std::memory_order_release);
+    }
+
+    /// Drop all entries, without deleting what they point to. Not safe to call concurrently with get or set.
+    void clear() {
+        for (uint64_t s = 0; s < n_segments; ++s) {
+            delete[] segments[s].load();
+            segments[s].store(nullptr);
+        }
+    }
+
+private:
+    static const uint64_t first_segment_bits = 6;
+    static const uint64_t n_segments = 64 - first_segment_bits;
+    std::atomic<std::atomic<T*>*> segments[n_segments];
+
+    static inline uint64_t segment_size(const uint64_t& s) {
+        return (uint64_t)1 << (s + first_segment_bits);
+    }
+
+    /// segment s holds the entries [(2^s - 1) * 2^first_segment_bits, (2^(s+1) - 1) * 2^first_segment_bits)
+    static inline void locate(const uint64_t& i, uint64_t& s, uint64_t& o) {
+        s = 63 - __builtin_clzll((i >> first_segment_bits) + 1);
+        o = i - ((((uint64_t)1 << s) - 1) << first_segment_bits);
+    }
+};
+
+}
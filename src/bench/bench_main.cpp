@@ -0,0 +1,297 @@
+// odgi_bench: throughput of the core handle graph operations on synthetic graphs.
+//
+// Every benchmark is run on each requested graph shape and thread count, a
+// number of times, and the fastest run is reported. Results go to stdout as
+// TSV, or as a JSON array, so CI can compare them between builds.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <omp.h>
+#include "args.hxx"
+#include "odgi.hpp"
+#include "algorithms/xp.hpp"
+#include "algorithms/path_sgd.hpp"
+#include "algorithms/instrumentation.hpp"
+#include "synthetic_graphs.hpp"
+#include "XoshiroCpp.hpp"
+
+using namespace odgi;
+using namespace odgi::bench;
+
+struct bench_result_t {
+    std::string benchmark;
+    std::string shape;
+    uint64_t nodes;
+    uint64_t paths;
+    uint64_t steps;
+    uint64_t threads;
+    uint64_t ops;          // operations of one run, e.g. edges followed or steps appended
+    double seconds;        // fastest run
+    uint64_t peak_rss_kb;  // high water mark of the benchmark's runs, graph included
+};
+
+/// Run setup then the timed body repeat times, returning the fastest time of the body. The RSS high water mark
+/// is reset first, so that the peak read after it belongs to these runs rather than to earlier benchmarks.
+static double time_best(const uint64_t& repeat,
+                        const std::function<void()>& setup,
+                        const std::function<void()>& body) {
+    algorithms::instrumentation::reset_rss_high_water_mark();
+    double best = std::numeric_limits<double>::max();
+    for (uint64_t r = 0; r < std::max((uint64_t)1, repeat); ++r) {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+static std::vector<uint64_t> parse_thread_counts(const std::string& list) {
+    std::vector<uint64_t> counts;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            counts.push_back(std::max((uint64_t)1, (uint64_t)std::stoull(item)));
+        }
+    }
+    return counts;
+}
+
+static void write_tsv(std::ostream& out, const std::vector<bench_result_t>& results) {
+    out << "benchmark\tshape\tnodes\tpaths\tsteps\tthreads\tops\tseconds\tops_per_s\tns_per_op\tpeak_rss_kb" << std::endl;
+    for (auto& r : results) {
+        out << r.benchmark << "\t" << r.shape << "\t" << r.nodes << "\t" << r.paths << "\t" << r.steps << "\t"
+            << r.threads << "\t" << r.ops << "\t" << r.seconds << "\t"
+            << (r.seconds > 0 ? r.ops / r.seconds : 0) << "\t"
+            << (r.ops > 0 ? r.seconds * 1e9 / r.ops : 0) << "\t"
+            << r.peak_rss_kb << std::endl;
+    }
+}
+
+static void write_json(std::ostream& out, const std::vector<bench_result_t>& results) {
+    out << "[" << std::endl;
+    for (uint64_t i = 0; i < results.size(); ++i) {
+        auto& r = results[i];
+        out << "  {\"benchmark\": \"" << r.benchmark << "\", \"shape\": \"" << r.shape << "\""
+            << ", \"nodes\": " << r.nodes << ", \"paths\": " << r.paths << ", \"steps\": " << r.steps
+            << ", \"threads\": " << r.threads << ", \"ops\": " << r.ops << ", \"seconds\": " << r.seconds
+            << ", \"ops_per_s\": " << (r.seconds > 0 ? r.ops / r.seconds : 0)
+            << ", \"ns_per_op\": " << (r.ops > 0 ? r.seconds * 1e9 / r.ops : 0)
+            << ", \"peak_rss_kb\": " << r.peak_rss_kb << "}"
+            << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    out << "]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    args::ArgumentParser parser("Benchmark the core handle graph operations of odgi on reproducible synthetic graphs.");
+    args::Group graph_opts(parser, "[ Synthetic Graph Options ]");
+    args::ValueFlag<std::string> _shapes(graph_opts, "SHAPE[,SHAPE]", "Graph shapes to benchmark, among linear, bubble and pangenome (default: all of them).", {'s', "shapes"});
+    args::ValueFlag<uint64_t> _nodes(graph_opts, "N", "Build graphs of about *N* nodes (default: 100000).", {'n', "nodes"});
+    args::ValueFlag<uint64_t> _node_length(graph_opts, "N", "Length of the chain and anchor nodes in bp (default: 32).", {'l', "node-length"});
+    args::ValueFlag<uint64_t> _paths(graph_opts, "N", "Number of paths in each graph (default: 16).", {'p', "paths"});
+    args::ValueFlag<uint64_t> _seed(graph_opts, "N", "Seed of the graph generators (default: 42).", {'S', "seed"});
+    args::Group bench_opts(parser, "[ Benchmark Options ]");
+    args::ValueFlag<std::string> _benchmarks(bench_opts, "NAME[,NAME]", "Benchmarks to run, among follow_edges, append_step, apply_ordering, serialize, deserialize, xp_build and path_linear_sgd (default: all of them).", {'b', "benchmarks"});
+    args::ValueFlag<std::string> _threads(bench_opts, "N[,N]", "Thread counts to run the multithreaded benchmarks with (default: 1).", {'t', "threads"});
+    args::ValueFlag<uint64_t> _repeat(bench_opts, "N", "Run each benchmark *N* times and report the fastest run (default: 3).", {'r', "repeat"});
+    args::ValueFlag<uint64_t> _sgd_iter_max(bench_opts, "N", "Iterations of path_linear_sgd (default: 5).", {'x', "sgd-iter-max"});
+    args::Group output_opts(parser, "[ Output Options ]");
+    args::Flag _json(output_opts, "json", "Write the results as a JSON array instead of TSV.", {'j', "json"});
+    args::ValueFlag<std::string> _out(output_opts, "FILE", "Write the results to this *FILE* instead of stdout.", {'o', "out"});
+    args::Flag _progress(output_opts, "progress", "Report each benchmark to stderr as it runs.", {'P', "progress"});
+    args::HelpFlag help(parser, "help", "Print a help message for odgi_bench.", {'h', "help"});
+
+    try {
+        parser.ParseCLI(argc, argv);
+    } catch (args::Help) {
+        std::cout << parser;
+        return 0;
+    } catch (args::ParseError e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    std::vector<graph_shape_t> shapes;
+    if (_shapes) {
+        std::stringstream ss(args::get(_shapes));
+        std::string name;
+        while (std::getline(ss, name, ',')) {
+            graph_shape_t shape;
+            if (!parse_graph_shape(name, shape)) {
+                std::cerr << "[odgi_bench] error: unknown graph shape '" << name << "'." << std::endl;
+                return 1;
+            }
+            shapes.push_back(shape);
+        }
+    } else {
+        shapes = {graph_shape_t::linear, graph_shape_t::bubble, graph_shape_t::pangenome};
+    }
+    const std::vector<std::string> all_benchmarks = {"follow_edges", "append_step", "apply_ordering",
+                                                     "serialize", "deserialize", "xp_build", "path_linear_sgd"};
+    std::vector<std::string> benchmarks;
+    if (_benchmarks) {
+        std::stringstream ss(args::get(_benchmarks));
+        std::string name;
+        while (std::getline(ss, name, ',')) {
+            if (std::find(all_benchmarks.begin(), all_benchmarks.end(), name) == all_benchmarks.end()) {
+                std::cerr << "[odgi_bench] error: unknown benchmark '" << name << "'." << std::endl;
+                return 1;
+            }
+            benchmarks.push_back(name);
+        }
+    } else {
+        benchmarks = all_benchmarks;
+    }
+    const uint64_t n_nodes = _nodes ? args::get(_nodes) : 100000;
+    const uint64_t node_length = _node_length ? args::get(_node_length) : 32;
+    const uint64_t n_paths = _paths ? args::get(_paths) : 16;
+    const uint64_t seed = _seed ? args::get(_seed) : 42;
+    const std::vector<uint64_t> thread_counts = _threads ? parse_thread_counts(args::get(_threads)) : std::vector<uint64_t>{1};
+    const uint64_t repeat = _repeat ? args::get(_repeat) : 3;
+    const uint64_t sgd_iter_max = _sgd_iter_max ? args::get(_sgd_iter_max) : 5;
+    const bool progress = args::get(_progress);
+    if (thread_counts.empty()) {
+        std::cerr << "[odgi_bench] error: please give at least one thread count with -t, --threads." << std::endl;
+        return 1;
+    }
+
+    std::vector<bench_result_t> results;
+    for (auto& shape : shapes) {
+        graph_t graph;
+        make_synthetic_graph(graph, shape, n_nodes, node_length, n_paths, seed);
+        uint64_t n_steps = 0;
+        std::vector<path_handle_t> paths;
+        graph.for_each_path_handle([&](const path_handle_t& p) {
+            paths.push_back(p);
+            n_steps += graph.get_step_count(p);
+        });
+        auto record = [&](const std::string& name, const uint64_t& threads, const uint64_t& ops, const double& seconds) {
+            results.push_back({name, graph_shape_name(shape), graph.get_node_count(), paths.size(), n_steps,
+                               threads, ops, seconds, algorithms::instrumentation::rss_high_water_mark_kb()});
+            if (progress) {
+                std::cerr << "[odgi_bench] " << name << " on " << graph_shape_name(shape) << " with " << threads
+                          << " threads: " << seconds << " s" << std::endl;
+            }
+        };
+        auto wanted = [&](const std::string& name) {
+            return std::find(benchmarks.begin(), benchmarks.end(), name) != benchmarks.end();
+        };
+
+        for (auto& threads : thread_counts) {
+            omp_set_num_threads(threads);
+            if (wanted("follow_edges")) {
+                std::atomic<uint64_t> followed(0);
+                double seconds = time_best(repeat, [&]() { followed.store(0); }, [&]() {
+                    graph.for_each_handle([&](const handle_t& h) {
+                        uint64_t n = 0;
+                        for (auto& handle : {h, graph.flip(h)}) {
+                            graph.follow_edges(handle, false, [&](const handle_t& o) { ++n; });
+                            graph.follow_edges(handle, true, [&](const handle_t& o) { ++n; });
+                        }
+                        followed.fetch_add(n);
+                    }, threads > 1);
+                });
+                record("follow_edges", threads, followed.load(), seconds);
+            }
+            if (wanted("xp_build")) {
+                double seconds = time_best(repeat, []() { }, [&]() {
+                    xp::XP path_index;
+                    path_index.from_handle_graph(graph, threads);
+                });
+                record("xp_build", threads, n_steps, seconds);
+            }
+            if (wanted("path_linear_sgd") && !paths.empty()) {
+                xp::XP path_index;
+                path_index.from_handle_graph(graph, threads);
+                uint64_t max_path_step_count = 0;
+                uint64_t max_path_length = 0;
+                for (auto& p : paths) {
+                    max_path_step_count = std::max(max_path_step_count, (uint64_t)graph.get_step_count(p));
+                    max_path_length = std::max(max_path_length, (uint64_t)path_index.get_path_length(p));
+                }
+                std::vector<std::string> snapshots;
+                double seconds = time_best(repeat, []() { }, [&]() {
+                    algorithms::path_linear_sgd(graph, path_index, paths,
+                                                sgd_iter_max, 0, n_steps, 0, 0.01,
+                                                (double)max_path_step_count * max_path_step_count, 0.99,
+                                                max_path_length, 100, 100, 0.5,
+                                                threads, false, false, snapshots);
+                });
+                record("path_linear_sgd", threads, sgd_iter_max * n_steps, seconds);
+            }
+        }
+
+        // single-threaded benchmarks
+        omp_set_num_threads(1);
+        if (wanted("append_step")) {
+            std::vector<std::vector<handle_t>> walks(paths.size());
+            for (uint64_t i = 0; i < paths.size(); ++i) {
+                for (auto& step : graph.steps_of_path(paths[i])) {
+                    walks[i].push_back(graph.get_handle_of_step(step));
+                }
+            }
+            graph_t into;
+            double seconds = time_best(repeat, [&]() {
+                into.copy(graph);
+                into.clear_paths();
+            }, [&]() {
+                for (uint64_t i = 0; i < walks.size(); ++i) {
+                    path_handle_t path = into.create_path_handle("path" + std::to_string(i));
+                    for (auto& h : walks[i]) {
+                        into.append_step(path, h);
+                    }
+                }
+            });
+            record("append_step", 1, n_steps, seconds);
+        }
+        if (wanted("apply_ordering")) {
+            std::vector<handle_t> order;
+            graph.for_each_handle([&](const handle_t& h) { order.push_back(h); });
+            XoshiroCpp::Xoshiro256Plus gen(seed);
+            for (uint64_t i = order.size(); i > 1; --i) {
+                std::swap(order[i - 1], order[(uint64_t)(XoshiroCpp::DoubleFromBits(gen()) * i)]);
+            }
+            graph_t shuffled;
+            double seconds = time_best(repeat, [&]() { shuffled.copy(graph); }, [&]() {
+                shuffled.apply_ordering(order, true);
+            });
+            record("apply_ordering", 1, order.size(), seconds);
+        }
+        if (wanted("serialize") || wanted("deserialize")) {
+            std::stringstream ss;
+            double seconds = time_best(repeat, [&]() { ss.str(""); }, [&]() {
+                graph.serialize_members(ss);
+            });
+            const uint64_t bytes = ss.str().size();
+            if (wanted("serialize")) {
+                record("serialize", 1, bytes, seconds);
+            }
+            if (wanted("deserialize")) {
+                const std::string data = ss.str();
+                graph_t loaded;
+                seconds = time_best(repeat, [&]() { loaded.clear(); ss.clear(); ss.str(data); }, [&]() {
+                    loaded.deserialize_members(ss);
+                });
+                record("deserialize", 1, bytes, seconds);
+            }
+        }
+    }
+
+    if (_out) {
+        std::ofstream out(args::get(_out));
+        if (args::get(_json)) write_json(out, results); else write_tsv(out, results);
+    } else {
+        if (args::get(_json)) write_json(std::cout, results); else write_tsv(std::cout, results);
+    }
+    return 0;
+}
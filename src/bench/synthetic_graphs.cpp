@@ -0,0 +1,126 @@
+#include "synthetic_graphs.hpp"
+#include "XoshiroCpp.hpp"
+
+namespace odgi {
+namespace bench {
+
+bool parse_graph_shape(const std::string& name, graph_shape_t& shape) {
+    if (name == "linear") {
+        shape = graph_shape_t::linear;
+    } else if (name == "bubble") {
+        shape = graph_shape_t::bubble;
+    } else if (name == "pangenome") {
+        shape = graph_shape_t::pangenome;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string graph_shape_name(const graph_shape_t& shape) {
+    switch (shape) {
+    case graph_shape_t::linear: return "linear";
+    case graph_shape_t::bubble: return "bubble";
+    case graph_shape_t::pangenome: return "pangenome";
+    }
+    return "";
+}
+
+static std::string random_sequence(XoshiroCpp::Xoshiro256Plus& gen, const uint64_t& length) {
+    static const char bases[4] = {'A', 'C', 'G', 'T'};
+    std::string seq(length, 'A');
+    for (auto& c : seq) {
+        c = bases[gen() >> 62];
+    }
+    return seq;
+}
+
+// uniform in [0, n), from the high bits, which are the good ones of Xoshiro256+
+static uint64_t random_below(XoshiroCpp::Xoshiro256Plus& gen, const uint64_t& n) {
+    return (uint64_t)(XoshiroCpp::DoubleFromBits(gen()) * n);
+}
+
+static void ensure_edge(graph_t& graph, const handle_t& from, const handle_t& to) {
+    if (!graph.has_edge(from, to)) {
+        graph.create_edge(from, to);
+    }
+}
+
+void make_synthetic_graph(graph_t& graph,
+                          const graph_shape_t& shape,
+                          const uint64_t& n_nodes,
+                          const uint64_t& node_length,
+                          const uint64_t& n_paths,
+                          const uint64_t& seed) {
+    XoshiroCpp::Xoshiro256Plus gen(seed);
+    const uint64_t length = std::max((uint64_t)1, node_length);
+    if (shape == graph_shape_t::linear) {
+        std::vector<handle_t> chain;
+        chain.reserve(n_nodes);
+        for (uint64_t i = 0; i < n_nodes; ++i) {
+            chain.push_back(graph.create_handle(random_sequence(gen, length)));
+            if (i > 0) {
+                graph.create_edge(chain[i - 1], chain[i]);
+            }
+        }
+        for (uint64_t p = 0; p < n_paths; ++p) {
+            path_handle_t path = graph.create_path_handle("path" + std::to_string(p));
+            for (auto& h : chain) {
+                graph.append_step(path, h);
+            }
+        }
+        return;
+    }
+
+    // a chain of anchors, each followed by a bubble of alleles, and a final anchor
+    const bool tangled = shape == graph_shape_t::pangenome;
+    std::vector<handle_t> anchors;
+    std::vector<std::vector<handle_t>> alleles;
+    uint64_t created = 0;
+    while (created + 1 < n_nodes || anchors.empty()) {
+        anchors.push_back(graph.create_handle(random_sequence(gen, length)));
+        ++created;
+        const uint64_t n_alleles = tangled ? 2 + random_below(gen, 3) : 2;
+        alleles.emplace_back();
+        for (uint64_t a = 0; a < n_alleles && created < n_nodes; ++a) {
+            const uint64_t allele_length = tangled ? 1 + random_below(gen, 2 * length) : 1;
+            alleles.back().push_back(graph.create_handle(random_sequence(gen, allele_length)));
+            ++created;
+        }
+    }
+    anchors.push_back(graph.create_handle(random_sequence(gen, length)));
+
+    for (uint64_t p = 0; p < n_paths; ++p) {
+        path_handle_t path = graph.create_path_handle("path" + std::to_string(p));
+        handle_t last = anchors.front();
+        graph.append_step(path, last);
+        for (uint64_t b = 0; b < alleles.size(); ++b) {
+            const handle_t& next_anchor = anchors[b + 1];
+            const double r = XoshiroCpp::DoubleFromBits(gen());
+            if (alleles[b].empty() || (tangled && r < 0.05)) {
+                // deletion, or a bubble without alleles
+                ensure_edge(graph, last, next_anchor);
+            } else {
+                handle_t allele = alleles[b][random_below(gen, alleles[b].size())];
+                if (tangled && r < 0.07) {
+                    // inversion
+                    allele = graph.flip(allele);
+                }
+                ensure_edge(graph, last, allele);
+                graph.append_step(path, allele);
+                if (tangled && r >= 0.07 && r < 0.08) {
+                    // repeat: loop back through the anchor and the allele again
+                    ensure_edge(graph, allele, last);
+                    graph.append_step(path, last);
+                    graph.append_step(path, allele);
+                }
+                ensure_edge(graph, allele, next_anchor);
+            }
+            graph.append_step(path, next_anchor);
+            last = next_anchor;
+        }
+    }
+}
+
+}
+}
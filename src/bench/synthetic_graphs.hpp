@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include "odgi.hpp"
+
+/**
+ * \file synthetic_graphs.hpp
+ *
+ * Reproducible synthetic graphs for benchmarking. The same shape, scale and seed always give the same graph.
+ */
+
+namespace odgi {
+namespace bench {
+
+using namespace handlegraph;
+
+enum class graph_shape_t {
+    linear,     // a single chain of nodes, walked end to end by every path
+    bubble,     // a chain of SNP-like bubbles, each path picks one allele per bubble
+    pangenome   // deep and tangled: multi-allelic bubbles, deletions, inversions and repeat loops
+};
+
+/// Parse "linear", "bubble" or "pangenome", returning false for anything else.
+bool parse_graph_shape(const std::string& name, graph_shape_t& shape);
+
+std::string graph_shape_name(const graph_shape_t& shape);
+
+/// Fill the empty graph with about n_nodes nodes of node_length bp and n_paths paths of the given shape.
+void make_synthetic_graph(graph_t& graph,
+                          const graph_shape_t& shape,
+                          const uint64_t& n_nodes,
+                          const uint64_t& node_length,
+                          const uint64_t& n_paths,
+                          const uint64_t& seed);
+
+}
+}
@@ -4,6 +4,7 @@
 // New subcommand system provides all the subcommands that used to live here
 #include "subcommand/subcommand.hpp"
 #include "version.hpp"
+#include "algorithms/instrumentation.hpp"
 
 using namespace std;
 using namespace odgi;
@@ -24,6 +25,9 @@ void odgi_help(char** argv) {
         cerr << "  -- " << name << command.get_description() << endl;
      });
 
+     cerr << endl
+          << "Any command also accepts --stats-json FILE, which writes the wall time, CPU time, peak memory" << endl
+          << "and item counts of its phases to FILE as JSON." << endl;
      cerr << endl;// << "For more commands, type `odgi help`." << endl;
  }
 
@@ -35,6 +39,22 @@ int main(int argc, char *argv[]) {
     // set a higher value for tcmalloc warnings
     setenv("TCMALLOC_LARGE_ALLOC_REPORT_THRESHOLD", "1000000000000000", 1);
 
+    // the global --stats-json FILE option may appear anywhere, and is removed before the subcommand sees its arguments
+    std::string stats_json;
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--stats-json" && i + 1 < argc) {
+            stats_json = argv[++i];
+        } else if (arg.rfind("--stats-json=", 0) == 0) {
+            stats_json = arg.substr(13);
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    argv[argc] = nullptr;
+
     if (argc == 1) {
         odgi_help(argv);
         return 0;
@@ -43,7 +63,12 @@ int main(int argc, char *argv[]) {
     const auto* subcommand = odgi::subcommand::Subcommand::get(argc, argv);
     if (subcommand != nullptr) {
         // We found a matching subcommand, so run it
-        return (*subcommand)(argc, argv);
+        if (!stats_json.empty()) {
+            odgi::algorithms::instrumentation::start(subcommand->get_name(), stats_json);
+        }
+        int ret = (*subcommand)(argc, argv);
+        odgi::algorithms::instrumentation::finish();
+        return ret;
     } else {
         // No subcommand found
         cerr << "[odgi] error: command '" << argv[1] << "' not found.\n\nType `odgi` to list the available commands.\n" << endl;
@@ -161,6 +161,32 @@ public:
                                                      uint64_t path_id,
                                                      bool is_rev)>& func) const;
     void for_each_path_step(const std::function<bool(step_t step)>& func) const;
+    /// Inlineable for_each_edge, calling func(other_id, other_rev, to_curr, on_rev) until it returns false.
+    template<typename F>
+    inline void for_each_edge_fast(F&& func) const {
+        const uint64_t n = edges.size();
+        for (uint64_t i = 0; i < n; i += EDGE_RECORD_LENGTH) {
+            const uint8_t packed_edge = edges.at(i+1);
+            if (!func(edges.at(i),
+                      (bool)edge_helper::unpack_other_rev(packed_edge),
+                      (bool)edge_helper::unpack_to_curr(packed_edge),
+                      (bool)edge_helper::unpack_on_rev(packed_edge))) {
+                break;
+            }
+        }
+    }
+    /// Inlineable for_each_path_step, calling func(rank, path_id, is_rev) on each live step until it returns false.
+    template<typename F>
+    inline void for_each_path_step_fast(F&& func) const {
+        const uint64_t n_paths = path_count();
+        for (uint64_t i = 0; i < n_paths; ++i) {
+            const uint8_t type = paths.at(PATH_RECORD_LENGTH*i+1);
+            if (!step_type_helper::unpack_is_del(type)
+                && !func(i, paths.at(PATH_RECORD_LENGTH*i), step_type_helper::unpack_is_rev(type))) {
+                break;
+            }
+        }
+    }
     std::pair<std::map<uint64_t, std::pair<uint64_t, bool>>, // path fronts and backs
           std::map<uint64_t, std::pair<uint64_t, bool>>> flip_paths(void);
     void remove_path_step(const uint64_t& rank);
@@ -19,6 +19,8 @@
 
 #include "odgi-api.h"
 #include "version.hpp"
+#include <cstring>
+#include <algorithm>
 
 using namespace odgi;
 
@@ -312,3 +314,169 @@ const bool odgi_for_each_step_on_handle(const ograph_t graph,
 const std::string odgi_get_path_name(const ograph_t graph, const path_handle_i ipath) {
   return (as_graph_t(graph))->get_path_name(as_path_handle(ipath));
 }
+
+// Language agnostic C interface, see odgi-c-api.h. Nothing may throw
+// across this boundary.
+
+odgi_c_graph* odgi_c_load_graph(const char* filename) {
+  std::ifstream in(filename);
+  if (!in) return nullptr;
+  auto* graph = new graph_t();
+  try {
+    graph->deserialize(in);
+  } catch (...) {
+    delete graph;
+    return nullptr;
+  }
+  return as_c_graph(graph);
+}
+
+void odgi_c_free_graph(odgi_c_graph* graph) {
+  delete as_graph_t(graph);
+}
+
+uint64_t odgi_c_get_node_count(const odgi_c_graph* graph) {
+  return as_graph_t(graph)->get_node_count();
+}
+
+uint64_t odgi_c_get_path_count(const odgi_c_graph* graph) {
+  return as_graph_t(graph)->get_path_count();
+}
+
+uint64_t odgi_c_get_handles(const odgi_c_graph* graph, uint64_t* handles, uint64_t capacity) {
+  uint64_t n = 0;
+  as_graph_t(graph)->for_each_handle_fast([&](const handle_t& h) {
+    if (n < capacity) handles[n] = as_handle_i(h);
+    ++n;
+  });
+  return n;
+}
+
+uint64_t odgi_c_get_path_handles(const odgi_c_graph* graph, uint64_t* paths, uint64_t capacity) {
+  uint64_t n = 0;
+  as_graph_t(graph)->for_each_path_handle([&](const path_handle_t& p) {
+    if (n < capacity) paths[n] = as_path_handle_i(p);
+    ++n;
+  });
+  return n;
+}
+
+uint64_t odgi_c_get_path_name(const odgi_c_graph* graph, uint64_t path, char* name, uint64_t capacity) {
+  const std::string path_name = as_graph_t(graph)->get_path_name(as_path_handle(path));
+  if (path_name.size() < capacity) {
+    std::memcpy(name, path_name.c_str(), path_name.size() + 1);
+  }
+  return path_name.size();
+}
+
+void odgi_c_get_ids(const odgi_c_graph* graph, const uint64_t* handles, uint64_t n, int64_t* ids) {
+  const graph_t* g = as_graph_t(graph);
+  for (uint64_t i = 0; i < n; ++i) {
+    ids[i] = g->get_id(as_handle(handles[i]));
+  }
+}
+
+void odgi_c_get_is_reverse(const odgi_c_graph* graph, const uint64_t* handles, uint64_t n, uint8_t* is_reverse) {
+  const graph_t* g = as_graph_t(graph);
+  for (uint64_t i = 0; i < n; ++i) {
+    is_reverse[i] = g->get_is_reverse(as_handle(handles[i]));
+  }
+}
+
+void odgi_c_get_lengths(const odgi_c_graph* graph, const uint64_t* handles, uint64_t n, uint64_t* lengths) {
+  const graph_t* g = as_graph_t(graph);
+  for (uint64_t i = 0; i < n; ++i) {
+    lengths[i] = g->get_length(as_handle(handles[i]));
+  }
+}
+
+uint64_t odgi_c_get_sequences(const odgi_c_graph* graph, const uint64_t* handles, uint64_t n,
+                              uint64_t* offsets, char* seq, uint64_t capacity) {
+  const graph_t* g = as_graph_t(graph);
+  offsets[0] = 0;
+  for (uint64_t i = 0; i < n; ++i) {
+    offsets[i + 1] = offsets[i] + g->get_length(as_handle(handles[i]));
+  }
+  for (uint64_t i = 0; i < n && offsets[i] < capacity; ++i) {
+    const std::string s = g->get_sequence(as_handle(handles[i]));
+    std::memcpy(seq + offsets[i], s.data(), std::min((uint64_t)s.size(), capacity - offsets[i]));
+  }
+  return offsets[n];
+}
+
+uint64_t odgi_c_get_edges(const odgi_c_graph* graph, const uint64_t* handles, uint64_t n, int go_left,
+                          uint64_t* offsets, uint64_t* neighbors, uint64_t capacity) {
+  const graph_t* g = as_graph_t(graph);
+  uint64_t k = 0;
+  for (uint64_t i = 0; i < n; ++i) {
+    offsets[i] = k;
+    g->follow_edges_fast(as_handle(handles[i]), go_left != 0, [&](const handle_t& h) {
+      if (k < capacity) neighbors[k] = as_handle_i(h);
+      ++k;
+    });
+  }
+  offsets[n] = k;
+  return k;
+}
+
+uint64_t odgi_c_get_path_step_count(const odgi_c_graph* graph, uint64_t path) {
+  return as_graph_t(graph)->get_step_count(as_path_handle(path));
+}
+
+uint64_t odgi_c_get_path_steps(const odgi_c_graph* graph, uint64_t path, odgi_c_step* steps, uint64_t capacity) {
+  const graph_t* g = as_graph_t(graph);
+  const uint64_t n = g->get_step_count(as_path_handle(path));
+  uint64_t k = 0;
+  if (capacity > 0) {
+    for (auto& step : g->steps_of_path(as_path_handle(path))) {
+      steps[k++] = as_c_step(step);
+      if (k == capacity) break;
+    }
+  }
+  return n;
+}
+
+odgi_c_path_cursor odgi_c_path_cursor_begin(const odgi_c_graph* graph, uint64_t path) {
+  const graph_t* g = as_graph_t(graph);
+  const path_handle_t p = as_path_handle(path);
+  const uint64_t n = g->get_step_count(p);
+  return { as_c_step(n ? g->path_begin(p) : g->path_end(p)), n };
+}
+
+uint64_t odgi_c_path_cursor_next(const odgi_c_graph* graph, odgi_c_path_cursor* cursor,
+                                 uint64_t* handles, uint64_t capacity) {
+  const graph_t* g = as_graph_t(graph);
+  step_handle_t step = as_step_handle_t(cursor->step);
+  uint64_t k = 0;
+  // in circular paths, we'll always have a next step, so we count the steps left instead
+  while (k < capacity && cursor->remaining > 0) {
+    handles[k++] = as_handle_i(g->get_handle_of_step(step));
+    if (--cursor->remaining > 0) {
+      step = g->get_next_step(step);
+    }
+  }
+  cursor->step = as_c_step(step);
+  return k;
+}
+
+uint64_t odgi_c_get_steps_on_handles(const odgi_c_graph* graph, const uint64_t* handles, uint64_t n,
+                                     uint64_t* offsets, odgi_c_step* steps, uint64_t capacity) {
+  const graph_t* g = as_graph_t(graph);
+  uint64_t k = 0;
+  for (uint64_t i = 0; i < n; ++i) {
+    offsets[i] = k;
+    g->for_each_step_on_handle_fast(as_handle(handles[i]), [&](const step_handle_t& step) {
+      if (k < capacity) steps[k] = as_c_step(step);
+      ++k;
+    });
+  }
+  offsets[n] = k;
+  return k;
+}
+
+void odgi_c_get_paths_of_steps(const odgi_c_graph* graph, const odgi_c_step* steps, uint64_t n, uint64_t* paths) {
+  const graph_t* g = as_graph_t(graph);
+  for (uint64_t i = 0; i < n; ++i) {
+    paths[i] = as_path_handle_i(g->get_path_handle_of_step(as_step_handle_t(steps[i])));
+  }
+}
@@ -111,8 +111,25 @@ const bool odgi_for_each_step_on_handle(const ograph_t graph,
 
 const std::string odgi_get_path_name(const ograph_t graph, const path_handle_i ipath);
 
-// Language agnostic C interface starts here
+// Language agnostic C interface, declared in odgi-c-api.h
 
-extern "C" {
-  // const char *odgi_c_get_path_name(const ograph_t graph, const path_handle_i path);
+#include "odgi-c-api.h"
+
+inline graph_t* as_graph_t(odgi_c_graph* graph) {
+  return reinterpret_cast<graph_t*>(graph);
+}
+inline const graph_t* as_graph_t(const odgi_c_graph* graph) {
+  return reinterpret_cast<const graph_t*>(graph);
+}
+inline odgi_c_graph* as_c_graph(graph_t* graph) {
+  return reinterpret_cast<odgi_c_graph*>(graph);
+}
+inline odgi_c_step as_c_step(const step_handle_t& step) {
+  return { as_integers(step)[0], as_integers(step)[1] };
+}
+inline step_handle_t as_step_handle_t(const odgi_c_step& step) {
+  step_handle_t s;
+  as_integers(s)[0] = step.handle;
+  as_integers(s)[1] = step.rank;
+  return s;
 }
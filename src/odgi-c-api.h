@@ -0,0 +1,83 @@
+// odgi-c-api.h ODGI plain C interface for FFIs
+//
+// Copyright (c) 2022 Erik Garrison and Pjotr Prins
+//
+// ODGI is published under the MIT license
+//
+// This header is valid C and does not pull in any C++ header, so it can
+// be read by C compilers and binding generators (bindgen, Julia's
+// ccall, Guile's FFI). The graph is an opaque pointer, handles and path
+// handles are plain 64-bit integers and a step is a pair of them.
+//
+// Batch calls fill caller-provided arrays. Calls that return a list
+// write at most `capacity` items and return the number of items that
+// are available, so a caller can ask for the size with a capacity of 0,
+// or retry with a larger buffer when the result exceeds its capacity.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct odgi_c_graph odgi_c_graph;
+
+typedef struct {
+  uint64_t handle;   // handle of the node visited, in the orientation of the visit
+  uint64_t rank;     // rank of the step among the steps on that node
+} odgi_c_step;
+
+// Position in a path for iterating over it in batches.
+typedef struct {
+  odgi_c_step step;  // next step to return
+  uint64_t remaining; // number of steps left
+} odgi_c_path_cursor;
+
+// Load a graph from an .og file. Returns NULL if it cannot be read.
+odgi_c_graph* odgi_c_load_graph(const char* filename);
+void odgi_c_free_graph(odgi_c_graph* graph);
+
+uint64_t odgi_c_get_node_count(const odgi_c_graph* graph);
+uint64_t odgi_c_get_path_count(const odgi_c_graph* graph);
+
+// The handles of all nodes, in their local forward orientation.
+uint64_t odgi_c_get_handles(const odgi_c_graph* graph, uint64_t* handles, uint64_t capacity);
+// The handles of all paths.
+uint64_t odgi_c_get_path_handles(const odgi_c_graph* graph, uint64_t* paths, uint64_t capacity);
+// The name of a path, NUL-terminated when it fits. Returns its length without the NUL.
+uint64_t odgi_c_get_path_name(const odgi_c_graph* graph, uint64_t path, char* name, uint64_t capacity);
+
+// Node ids, orientations and lengths of n handles.
+void odgi_c_get_ids(const odgi_c_graph* graph, const uint64_t* handles, uint64_t n, int64_t* ids);
+void odgi_c_get_is_reverse(const odgi_c_graph* graph, const uint64_t* handles, uint64_t n, uint8_t* is_reverse);
+void odgi_c_get_lengths(const odgi_c_graph* graph, const uint64_t* handles, uint64_t n, uint64_t* lengths);
+// The sequences of n handles, concatenated into seq (not NUL-terminated). offsets, of n + 1
+// entries, is always filled: the sequence of handles[i] is [offsets[i], offsets[i + 1]).
+uint64_t odgi_c_get_sequences(const odgi_c_graph* graph, const uint64_t* handles, uint64_t n,
+                              uint64_t* offsets, char* seq, uint64_t capacity);
+// The handles to the right (go_left = 0) or left of n handles. offsets, of n + 1 entries, is
+// always filled: the neighbors of handles[i] are [offsets[i], offsets[i + 1]) of neighbors.
+uint64_t odgi_c_get_edges(const odgi_c_graph* graph, const uint64_t* handles, uint64_t n, int go_left,
+                          uint64_t* offsets, uint64_t* neighbors, uint64_t capacity);
+
+uint64_t odgi_c_get_path_step_count(const odgi_c_graph* graph, uint64_t path);
+// The steps of a path, from first through last.
+uint64_t odgi_c_get_path_steps(const odgi_c_graph* graph, uint64_t path, odgi_c_step* steps, uint64_t capacity);
+// A cursor at the first step of a path.
+odgi_c_path_cursor odgi_c_path_cursor_begin(const odgi_c_graph* graph, uint64_t path);
+// Write the handles of up to capacity steps from the cursor and advance it past them.
+// Returns the number written, which is 0 once the path is exhausted.
+uint64_t odgi_c_path_cursor_next(const odgi_c_graph* graph, odgi_c_path_cursor* cursor,
+                                 uint64_t* handles, uint64_t capacity);
+// The steps on n handles. offsets, of n + 1 entries, is always filled.
+uint64_t odgi_c_get_steps_on_handles(const odgi_c_graph* graph, const uint64_t* handles, uint64_t n,
+                                     uint64_t* offsets, odgi_c_step* steps, uint64_t capacity);
+// The path of each of n steps.
+void odgi_c_get_paths_of_steps(const odgi_c_graph* graph, const odgi_c_step* steps, uint64_t n, uint64_t* paths);
+
+#ifdef __cplusplus
+}
+#endif
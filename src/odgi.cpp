@@ -194,23 +194,15 @@ edge_t graph_t::edge_handle(const handle_t& left, const handle_t& right) const {
 ////////////////////////////////////////////////////////////////////////////
 
 graph_t::path_metadata_t& graph_t::get_path_metadata(const path_handle_t& path) const {
-    graph_t::path_metadata_t* p;
-    if (path_metadata_h->Find(as_integer(path), p)) {
-        return *p;
-    } else {
-        assert(false);
-        return *p; // won't reach unless assert is disabled
-    }
+    graph_t::path_metadata_t* p = path_metadata_v.get(as_integer(path));
+    assert(p != nullptr);
+    return *p;
 }
 
 const graph_t::path_metadata_t& graph_t::path_metadata(const path_handle_t& path) const {
-    graph_t::path_metadata_t* p;
-    if (path_metadata_h->Find(as_integer(path), p)) {
-        return *p;
-    } else {
-        assert(false);
-        return *p; // won't reach unless assert is disabled
-    }
+    const graph_t::path_metadata_t* p = path_metadata_v.get(as_integer(path));
+    assert(p != nullptr);
+    return *p;
 }
 
 /// Determine if a path name exists and is legal to get a path handle for.
@@ -250,8 +242,7 @@ size_t graph_t::get_path_count() const {
 bool graph_t::for_each_path_handle_impl(const std::function<bool(const path_handle_t&)>& iteratee) const {
     bool flag = true;
     for (uint64_t i = 1; i <= _path_handle_next; ++i) {
-        path_metadata_t* p;
-        if (path_metadata_h->Find(i, p)) {
+        if (path_metadata_v.get(i) != nullptr) {
             flag &= iteratee(as_path_handle(i));
         }
     }
@@ -492,6 +483,31 @@ void graph_t::for_each_step_in_path(const path_handle_t& path, const std::functi
     } while (keep_going);
 }
 
+/// Decode the handles to next/previous (right/left) nodes into buffer, which is cleared first.
+size_t graph_t::get_edges(const handle_t& handle, bool go_left, std::vector<handle_t>& buffer) const {
+    buffer.clear();
+    follow_edges_fast(handle, go_left, [&](const handle_t& h) { buffer.push_back(h); });
+    return buffer.size();
+}
+
+/// Decode the path steps on a given handle into buffer, which is cleared first.
+size_t graph_t::get_steps_on_handle(const handle_t& handle, std::vector<step_handle_t>& buffer) const {
+    buffer.clear();
+    buffer.reserve(get_node_cref(handle).path_count());
+    for_each_step_on_handle_fast(handle, [&](const step_handle_t& step) { buffer.push_back(step); });
+    return buffer.size();
+}
+
+/// Return the steps of a path from first through last.
+graph_t::path_steps_t graph_t::steps_of_path(const path_handle_t& path) const {
+    const step_handle_t end_step = path_end(path);
+    if (is_empty(path)) {
+        return { path_step_iterator_t(this, end_step, end_step), path_step_iterator_t(this, end_step, end_step) };
+    }
+    const step_handle_t back = path_back(path);
+    return { path_step_iterator_t(this, path_begin(path), back), path_step_iterator_t(this, end_step, back) };
+}
+
 /// Create a new node with the given sequence and return the handle.
 handle_t graph_t::create_handle(const std::string& sequence) {
     // get first deleted node to recycle
@@ -695,12 +711,13 @@ void graph_t::clear() {
     node_v.clear();
     for_each_path_handle(
         [&](const path_handle_t& p) {
-            // remove from both hash tables
+            // remove from the metadata table and the name hash table
             auto s = get_path_name(p);
             delete &get_path_metadata(p);
-            path_metadata_h->Delete(as_integer(p));
+            path_metadata_v.set(as_integer(p), nullptr);
             path_name_h->Delete(s);
         });
+    path_metadata_v.clear();
     _path_count = 0;
     _path_handle_next = 0;
 }
@@ -713,12 +730,13 @@ void graph_t::clear_paths() {
         });
     for_each_path_handle(
         [&](const path_handle_t& p) {
-            // remove from both hash tables
+            // remove from the metadata table and the name hash table
             auto s = get_path_name(p);
             delete &get_path_metadata(p);
-            path_metadata_h->Delete(as_integer(p));
+            path_metadata_v.set(as_integer(p), nullptr);
             path_name_h->Delete(s);
         });
+    path_metadata_v.clear();
     _path_count = 0;
     _path_handle_next = 0;
 }
@@ -838,11 +856,11 @@ void graph_t::apply_ordering(const std::vector<handle_t>& order_in, bool compact
     // path metadata
 #pragma omp parallel for schedule(static, 1) num_threads(_num_threads)
     for (uint64_t i = 1; i <= _path_handle_next; ++i) {
-        path_metadata_t* p;
-        if (path_metadata_h->Find(i, p)) {
+        path_metadata_t* p = path_metadata_v.get(i);
+        if (p != nullptr) {
             const auto& path = as_path_handle(i);
             auto& old_meta = path_metadata(as_path_handle(i));
-            path_metadata_h->Delete(as_integer(path));
+            path_metadata_v.set(as_integer(path), nullptr);
             path_name_h->Delete(p->name);
             p = new path_metadata_t();
             p->handle.store(old_meta.handle); // same by def
@@ -862,7 +880,7 @@ void graph_t::apply_ordering(const std::vector<handle_t>& order_in, bool compact
             p->last.store(l);
             p->name = old_meta.name;
             p->is_circular.store(old_meta.is_circular);
-            path_metadata_h->Insert(as_integer(path), p);
+            path_metadata_v.set(as_integer(path), p);
             path_name_h->Insert(p->name, p);
             delete &old_meta;
         }
@@ -919,10 +937,10 @@ void graph_t::apply_path_ordering(const std::vector<path_handle_t>& order) {
             // update our internal handle
             p_m.handle.store(get_new_path_handle(path));
             metadata.push_back(&p_m);
-            path_metadata_h->Delete(as_integer(path));
+            path_metadata_v.set(as_integer(path), nullptr);
         });
     for (auto* m : metadata) {
-        path_metadata_h->Insert(as_integer(m->handle), m);
+        path_metadata_v.set(as_integer(m->handle), m);
     }
     // and to the nodes in parallel
     auto get_new_path_id =
@@ -1133,6 +1151,249 @@ std::vector<handle_t> graph_t::divide_handle(const handle_t& handle, const std::
     return h_is_rev ? rev_handles : handles;
 }
 
+std::vector<std::vector<handle_t>> graph_t::divide_handles(
+    const std::vector<std::pair<handle_t, std::vector<size_t>>>& divisions) {
+    const uint64_t old_size = node_v.size();
+    // the piece boundaries of each division on the forward strand, from 0 to the node length
+    std::vector<std::vector<uint64_t>> bounds(divisions.size());
+#pragma omp parallel for schedule(static, 1) num_threads(_num_threads)
+    for (uint64_t i = 0; i < divisions.size(); ++i) {
+        const handle_t& handle = divisions[i].first;
+        const uint64_t length = get_length(handle);
+        auto& b = bounds[i];
+        b.push_back(0);
+        for (auto& o : divisions[i].second) {
+            const uint64_t fwd = get_is_reverse(handle) ? length - o : o;
+            if (fwd > 0 && fwd < length) {
+                b.push_back(fwd);
+            }
+        }
+        b.push_back(length);
+        std::sort(b.begin(), b.end());
+        b.erase(std::unique(b.begin(), b.end()), b.end());
+    }
+
+    // the pieces of each divided node get the ranks after the current ones, in the order of the divisions
+    // division_of[rank] is 1 + the index of the division of the node, or 0 if it is not divided
+    std::vector<uint64_t> division_of(old_size, 0);
+    std::vector<uint64_t> first_piece_rank(divisions.size(), 0);
+    std::vector<uint64_t> divided;
+    uint64_t next_rank = old_size;
+    for (uint64_t i = 0; i < divisions.size(); ++i) {
+        const uint64_t rank = number_bool_packing::unpack_number(divisions[i].first);
+        assert(division_of[rank] == 0);
+        if (bounds[i].size() > 2) {
+            division_of[rank] = i + 1;
+            first_piece_rank[i] = next_rank;
+            next_rank += bounds[i].size() - 1;
+            divided.push_back(i);
+        }
+    }
+    if (divided.empty()) {
+        std::vector<std::vector<handle_t>> parts;
+        for (auto& d : divisions) {
+            parts.push_back({ d.first });
+        }
+        return parts;
+    }
+    node_v.resize(next_rank, nullptr);
+    _max_node_id = next_rank;
+
+    // edge and step records hold node ids, i.e. ranks shifted by 1 and the id increment
+    const nid_t id_increment = _id_increment;
+    auto id_of_rank = [&](const uint64_t& rank) -> uint64_t {
+        return rank + 1 + id_increment;
+    };
+    auto division = [&](const uint64_t& id) -> uint64_t {
+        const uint64_t rank = id - 1 - id_increment;
+        return rank < old_size ? division_of[rank] : 0;
+    };
+    // the id of the piece on the given side of the node
+    auto side_id = [&](const uint64_t& id, const bool& right) -> uint64_t {
+        const uint64_t d = division(id);
+        if (d == 0) {
+            return id;
+        }
+        return id_of_rank(first_piece_rank[d - 1] + (right ? bounds[d - 1].size() - 2 : 0));
+    };
+    // the piece on which a path enters or leaves the node at the given step, read from the unmodified node
+    auto enter_id = [&](const uint64_t& id, const uint64_t& rank) {
+        return division(id) == 0 ? id : side_id(id, node_v[id - 1 - id_increment]->step_is_rev(rank));
+    };
+    auto exit_id = [&](const uint64_t& id, const uint64_t& rank) {
+        return division(id) == 0 ? id : side_id(id, !node_v[id - 1 - id_increment]->step_is_rev(rank));
+    };
+
+    // build the pieces of the divided nodes, each from its own node only
+    // a step at rank r on a divided node becomes a step at rank r on each piece,
+    // so that the steps elsewhere keep their ranks when pointing to the pieces
+    const uint64_t path_slots = _path_handle_next + 1;
+    std::vector<uint64_t> added_steps(path_slots, 0);
+#pragma omp parallel num_threads(_num_threads)
+    {
+        std::vector<uint64_t> thread_added_steps(path_slots, 0);
+#pragma omp for schedule(static, 1)
+        for (uint64_t k = 0; k < divided.size(); ++k) {
+            const uint64_t i = divided[k];
+            const uint64_t rank = number_bool_packing::unpack_number(divisions[i].first);
+            const node_t& node = *node_v[rank];
+            const uint64_t id = id_of_rank(rank);
+            const std::string& seq = node.get_sequence();
+            const auto& b = bounds[i];
+            const uint64_t n_pieces = b.size() - 1;
+            const uint64_t first_rank = first_piece_rank[i];
+            for (uint64_t j = 0; j < n_pieces; ++j) {
+                node_t* piece = new node_t();
+                piece->set_id(first_rank + j + 1);
+                piece->set_sequence(seq.substr(b[j], b[j + 1] - b[j]));
+                // connect the pieces head to tail
+                if (j > 0) {
+                    piece->add_edge(id_of_rank(first_rank + j - 1), false, true, false);
+                }
+                if (j + 1 < n_pieces) {
+                    piece->add_edge(id_of_rank(first_rank + j + 1), false, false, false);
+                }
+                node_v[first_rank + j] = piece;
+            }
+            // move the edges to the end pieces
+            node.for_each_edge([&](uint64_t other_id, bool other_rev, bool to_curr, bool on_rev) {
+                const uint64_t here = side_id(id, to_curr == on_rev);
+                const uint64_t there = side_id(other_id, other_rev != to_curr);
+                node_v[here - 1 - id_increment]->add_edge(there, other_rev, to_curr, on_rev);
+                if (other_id == id && there != here) {
+                    // a self loop now joins two pieces, each of which needs its own record
+                    node_v[there - 1 - id_increment]->add_edge(here, on_rev, !to_curr, other_rev);
+                }
+                return true;
+            });
+            // copy the steps onto the pieces
+            const uint64_t n_steps = node.path_count();
+            for (uint64_t r = 0; r < n_steps; ++r) {
+                const node_t::step_t step = node.get_path_step(r);
+                if (step.path_id == 0) {
+                    // a destroyed step, kept to preserve the ranks
+                    for (uint64_t j = 0; j < n_pieces; ++j) {
+                        node_t& piece = *node_v[first_rank + j];
+                        piece.add_path_step(0, false, false, false, piece.get_id(), 0, piece.get_id(), 0);
+                    }
+                    continue;
+                }
+                thread_added_steps[step.path_id] += n_pieces - 1;
+                for (uint64_t j = 0; j < n_pieces; ++j) {
+                    // the position of this piece along the path's traversal of the node
+                    const uint64_t t = step.is_rev ? n_pieces - 1 - j : j;
+                    const uint64_t prev_piece = step.is_rev ? j + 1 : j - 1;
+                    const uint64_t next_piece = step.is_rev ? j - 1 : j + 1;
+                    const bool is_start = t == 0 && step.is_start;
+                    const bool is_end = t == n_pieces - 1 && step.is_end;
+                    // path starts and ends point to their own node
+                    const uint64_t prev_id = t > 0 ? id_of_rank(first_rank + prev_piece)
+                        : (is_start ? 0 : exit_id(step.prev_id, step.prev_rank));
+                    const uint64_t prev_rank = t > 0 ? r : step.prev_rank;
+                    const uint64_t next_id = t < n_pieces - 1 ? id_of_rank(first_rank + next_piece)
+                        : (is_end ? 0 : enter_id(step.next_id, step.next_rank));
+                    const uint64_t next_rank = t < n_pieces - 1 ? r : step.next_rank;
+                    node_v[first_rank + j]->add_path_step(step.path_id, step.is_rev, is_start, is_end,
+                                                          prev_id, prev_rank, next_id, next_rank);
+                }
+            }
+        }
+#pragma omp critical (added_steps)
+        for (uint64_t p = 0; p < path_slots; ++p) {
+            added_steps[p] += thread_added_steps[p];
+        }
+    }
+
+    // point the edges and steps of the other nodes to the pieces, each node rewriting only itself
+#pragma omp parallel for schedule(static, 1) num_threads(_num_threads)
+    for (uint64_t rank = 0; rank < old_size; ++rank) {
+        node_t* node = node_v[rank];
+        if (node == nullptr || division_of[rank]) {
+            continue;
+        }
+        bool touches_divided = false;
+        node->for_each_edge([&](uint64_t other_id, bool other_rev, bool to_curr, bool on_rev) {
+            touches_divided = division(other_id) != 0;
+            return !touches_divided;
+        });
+        if (touches_divided) {
+            std::vector<std::tuple<uint64_t, bool, bool, bool>> edges;
+            node->for_each_edge([&](uint64_t other_id, bool other_rev, bool to_curr, bool on_rev) {
+                edges.push_back(std::make_tuple(side_id(other_id, other_rev != to_curr), other_rev, to_curr, on_rev));
+                return true;
+            });
+            node->clear_edges();
+            for (auto& e : edges) {
+                node->add_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e), std::get<3>(e));
+            }
+        }
+        const uint64_t n_steps = node->path_count();
+        for (uint64_t r = 0; r < n_steps; ++r) {
+            const node_t::step_t step = node->get_path_step(r);
+            if (step.path_id == 0) {
+                continue;
+            }
+            if (!step.is_start && division(step.prev_id)) {
+                node->set_step_prev_id(r, exit_id(step.prev_id, step.prev_rank));
+            }
+            if (!step.is_end && division(step.next_id)) {
+                node->set_step_next_id(r, enter_id(step.next_id, step.next_rank));
+            }
+        }
+    }
+
+    // update the path ends and lengths
+    for (uint64_t i = 1; i <= _path_handle_next; ++i) {
+        path_metadata_t* p = path_metadata_v.get(i);
+        if (p == nullptr || p->length == 0) {
+            continue;
+        }
+        p->length += added_steps[i];
+        step_handle_t first = p->first.load();
+        const handle_t first_h = as_handle((uint64_t&)as_integers(first)[0]);
+        if (division(get_id(first_h))) {
+            const uint64_t piece_id = enter_id(get_id(first_h), as_integers(first)[1]);
+            as_integers(first)[0] = as_integer(get_handle(piece_id, get_is_reverse(first_h)));
+            p->first.store(first);
+        }
+        step_handle_t last = p->last.load();
+        const handle_t last_h = as_handle((uint64_t&)as_integers(last)[0]);
+        if (division(get_id(last_h))) {
+            const uint64_t piece_id = exit_id(get_id(last_h), as_integers(last)[1]);
+            as_integers(last)[0] = as_integer(get_handle(piece_id, get_is_reverse(last_h)));
+            p->last.store(last);
+        }
+    }
+
+    // remove the divided nodes
+    uint64_t internal_edges = 0;
+    std::vector<std::vector<handle_t>> parts(divisions.size());
+    for (uint64_t i = 0; i < divisions.size(); ++i) {
+        const handle_t& handle = divisions[i].first;
+        const uint64_t rank = number_bool_packing::unpack_number(handle);
+        if (!division_of[rank]) {
+            parts[i].push_back(handle);
+            continue;
+        }
+        const uint64_t n_pieces = bounds[i].size() - 1;
+        internal_edges += n_pieces - 1;
+        for (uint64_t j = 0; j < n_pieces; ++j) {
+            parts[i].push_back(number_bool_packing::pack(first_piece_rank[i] + j, false));
+        }
+        if (get_is_reverse(handle)) {
+            for (auto& h : parts[i]) {
+                h = flip(h);
+            }
+            std::reverse(parts[i].begin(), parts[i].end());
+        }
+        delete node_v[rank];
+        node_v[rank] = nullptr;
+        deleted_nodes.insert(rank + 1);
+    }
+    _edge_count += internal_edges;
+    return parts;
+}
+
 handle_t graph_t::combine_handles(const std::vector<handle_t>& handles) {
     std::string seq;
     for (auto& handle : handles) {
@@ -1180,6 +1441,307 @@ handle_t graph_t::combine_handles(const std::vector<handle_t>& handles) {
     return combined;
 }
 
+std::vector<std::vector<handle_t>> graph_t::combine_handle_runs(const std::vector<std::vector<handle_t>>& runs) {
+    const uint64_t old_size = node_v.size();
+    // edge and step records hold node ids, i.e. ranks shifted by 1 and the id increment
+    const nid_t id_increment = _id_increment;
+    auto rank_of_id = [&](const uint64_t& id) -> uint64_t {
+        return id - 1 - id_increment;
+    };
+
+    // match the two ends of each traversal of a run: the step on the last node of the run
+    // of the traversal that has rank r on the first node, and the reverse
+    // the traversal takes the rank of its step on the first node
+    // a run is only merged if every step on its nodes belongs to a traversal from end to end
+    const uint64_t no_step = std::numeric_limits<uint64_t>::max();
+    std::vector<std::vector<uint64_t>> first_to_last(runs.size());
+    std::vector<std::vector<uint64_t>> last_to_first(runs.size());
+    std::vector<uint8_t> mergeable(runs.size(), 0);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(_num_threads)
+    for (uint64_t i = 0; i < runs.size(); ++i) {
+        auto& run = runs[i];
+        assert(run.size() >= 2);
+        const node_t& first = get_node_cref(run.front());
+        const node_t& last = get_node_cref(run.back());
+        const bool first_rev = get_is_reverse(run.front());
+        first_to_last[i].resize(first.path_count(), no_step);
+        last_to_first[i].resize(last.path_count(), no_step);
+        bool ok = true;
+        uint64_t traversals = 0;
+        for (uint64_t r = 0; ok && r < first.path_count(); ++r) {
+            const node_t::step_t step = first.get_path_step(r);
+            if (step.path_id == 0) {
+                continue;
+            }
+            ++traversals;
+            // walk through the run along the path, forward or backward as it traverses the run,
+            // checking that the path neither starts nor ends inside the run
+            const bool forward = step.is_rev == first_rev;
+            node_t::step_t s = step;
+            uint64_t rank = r;
+            for (uint64_t j = 1; ok && j < run.size(); ++j) {
+                if (forward ? s.is_end : s.is_start) {
+                    ok = false;
+                    break;
+                }
+                const uint64_t id = forward ? s.next_id : s.prev_id;
+                rank = forward ? s.next_rank : s.prev_rank;
+                const node_t& node = get_node_cref(run[j]);
+                if (id != get_id(run[j]) || rank >= node.path_count()) {
+                    ok = false;
+                    break;
+                }
+                s = node.get_path_step(rank);
+                ok = s.path_id == step.path_id && s.is_rev == (forward == get_is_reverse(run[j]));
+            }
+            if (ok && last_to_first[i][rank] == no_step) {
+                first_to_last[i][r] = rank;
+                last_to_first[i][rank] = r;
+            } else {
+                ok = false;
+            }
+        }
+        // steps of paths that start or end inside the run are not on a traversal
+        for (uint64_t j = 1; ok && j < run.size(); ++j) {
+            uint64_t live_steps = 0;
+            get_node_cref(run[j]).for_each_path_step([&](const node_t::step_t& step) {
+                live_steps += step.path_id != 0;
+                return true;
+            });
+            ok = live_steps == traversals;
+        }
+        mergeable[i] = ok;
+    }
+
+    // run_of[rank] is 1 + the index of the run of the node, or 0 if it is in none
+    // run_place[rank] tells if the node starts or ends its run, run_rev[rank] its orientation in the run
+    const uint8_t run_first = 1;
+    const uint8_t run_last = 2;
+    std::vector<uint64_t> run_of(old_size, 0);
+    std::vector<uint8_t> run_place(old_size, 0);
+    std::vector<uint8_t> run_rev(old_size, 0);
+    // the merged runs get the ranks after the current ones, in the order of the runs
+    std::vector<uint64_t> run_rank(runs.size(), 0);
+    uint64_t next_rank = old_size;
+    for (uint64_t i = 0; i < runs.size(); ++i) {
+        if (mergeable[i]) {
+            run_rank[i] = next_rank++;
+        }
+    }
+#pragma omp parallel for schedule(static, 1) num_threads(_num_threads)
+    for (uint64_t i = 0; i < runs.size(); ++i) {
+        if (!mergeable[i]) {
+            continue;
+        }
+        auto& run = runs[i];
+        for (auto& h : run) {
+            const uint64_t rank = number_bool_packing::unpack_number(h);
+            run_of[rank] = i + 1;
+            run_rev[rank] = get_is_reverse(h);
+        }
+        run_place[number_bool_packing::unpack_number(run.front())] = run_first;
+        run_place[number_bool_packing::unpack_number(run.back())] = run_last;
+    }
+    if (next_rank > old_size) {
+        node_v.resize(next_rank, nullptr);
+        _max_node_id = next_rank;
+    }
+
+    auto run_id = [&](const uint64_t& i) -> uint64_t {
+        return run_rank[i] + 1 + id_increment;
+    };
+    auto run_of_id = [&](const uint64_t& id) -> uint64_t {
+        const uint64_t rank = rank_of_id(id);
+        return rank < old_size ? run_of[rank] : 0;
+    };
+
+    // the id and rank of a step after merging
+    auto map_step = [&](const uint64_t& id, const uint64_t& rank) -> std::pair<uint64_t, uint64_t> {
+        const uint64_t i = run_of_id(id);
+        if (i == 0) {
+            return std::make_pair(id, rank);
+        }
+        assert(run_place[rank_of_id(id)] != 0);
+        return std::make_pair(run_id(i - 1),
+                              run_place[rank_of_id(id)] == run_first ? rank : last_to_first[i - 1][rank]);
+    };
+    // the id and orientation of a node end after merging
+    auto map_node = [&](const uint64_t& id, const bool& is_rev) -> std::pair<uint64_t, bool> {
+        const uint64_t i = run_of_id(id);
+        if (i == 0) {
+            return std::make_pair(id, is_rev);
+        }
+        return std::make_pair(run_id(i - 1), is_rev != (bool)run_rev[rank_of_id(id)]);
+    };
+
+    // build the node of each run from the nodes of the run only
+    const uint64_t path_slots = _path_handle_next + 1;
+    std::vector<uint64_t> removed_steps(path_slots, 0);
+#pragma omp parallel num_threads(_num_threads)
+    {
+        std::vector<uint64_t> thread_removed_steps(path_slots, 0);
+#pragma omp for schedule(dynamic, 1)
+        for (uint64_t i = 0; i < runs.size(); ++i) {
+            if (!mergeable[i]) {
+                continue;
+            }
+            auto& run = runs[i];
+            std::string seq;
+            for (auto& h : run) {
+                seq.append(get_sequence(h));
+            }
+            node_t* merged = new node_t();
+            merged->set_id(run_rank[i] + 1);
+            merged->set_sequence(seq);
+            const uint64_t id = run_id(i);
+
+            // the edges leaving the run from the left of its first and the right of its last node
+            // an edge from the run back to itself is seen from both ends, so self loops are deduplicated
+            std::vector<std::tuple<bool, bool, bool>> self_loops;
+            for (auto& end : { run.front(), run.back() }) {
+                const bool keep_right = end == run.back();
+                const bool end_rev = get_is_reverse(end);
+                get_node_cref(end).for_each_edge([&](uint64_t other_id, bool other_rev, bool to_curr, bool on_rev) {
+                    const bool run_right = (to_curr == on_rev) != end_rev;
+                    if (run_right != keep_right) {
+                        // within the run
+                        return true;
+                    }
+                    const auto other = map_node(other_id, other_rev);
+                    if (other.first == id) {
+                        // store the self loop in the smaller of its two equivalent records
+                        auto loop = std::make_tuple(other.second, to_curr, on_rev != end_rev);
+                        auto reciprocal = std::make_tuple(on_rev != end_rev, !to_curr, other.second);
+                        self_loops.push_back(std::min(loop, reciprocal));
+                    } else {
+                        merged->add_edge(other.first, other.second, to_curr, on_rev != end_rev);
+                    }
+                    return true;
+                });
+            }
+            std::sort(self_loops.begin(), self_loops.end());
+            self_loops.erase(std::unique(self_loops.begin(), self_loops.end()), self_loops.end());
+            for (auto& loop : self_loops) {
+                merged->add_edge(id, std::get<0>(loop), std::get<1>(loop), std::get<2>(loop));
+            }
+
+            // one step for each traversal of the run, at the rank of its step on the first node
+            const node_t& first = get_node_cref(run.front());
+            const node_t& last = get_node_cref(run.back());
+            const bool first_rev = get_is_reverse(run.front());
+            for (uint64_t r = 0; r < first.path_count(); ++r) {
+                const node_t::step_t step = first.get_path_step(r);
+                if (step.path_id == 0) {
+                    // a destroyed step, kept to preserve the ranks
+                    merged->add_path_step(0, false, false, false, merged->get_id(), 0, merged->get_id(), 0);
+                    continue;
+                }
+                thread_removed_steps[step.path_id] += run.size() - 1;
+                const node_t::step_t last_step = last.get_path_step(first_to_last[i][r]);
+                const bool forward = step.is_rev == first_rev;
+                // the path enters the run on one end and leaves it on the other
+                const node_t::step_t& in = forward ? step : last_step;
+                const node_t::step_t& out = forward ? last_step : step;
+                const auto prev = in.is_start ? std::make_pair(in.prev_id, in.prev_rank)
+                    : map_step(in.prev_id, in.prev_rank);
+                const auto next = out.is_end ? std::make_pair(out.next_id, out.next_rank)
+                    : map_step(out.next_id, out.next_rank);
+                merged->add_path_step(step.path_id, !forward, in.is_start, out.is_end,
+                                      prev.first, prev.second, next.first, next.second);
+            }
+            node_v[run_rank[i]] = merged;
+        }
+#pragma omp critical (removed_steps)
+        for (uint64_t p = 0; p < path_slots; ++p) {
+            removed_steps[p] += thread_removed_steps[p];
+        }
+    }
+
+    // point the edges and steps of the other nodes to the merged nodes, each node rewriting only itself
+#pragma omp parallel for schedule(static, 1) num_threads(_num_threads)
+    for (uint64_t rank = 0; rank < old_size; ++rank) {
+        node_t* node = node_v[rank];
+        if (node == nullptr || run_of[rank]) {
+            continue;
+        }
+        bool touches_run = false;
+        node->for_each_edge([&](uint64_t other_id, bool other_rev, bool to_curr, bool on_rev) {
+            touches_run = run_of_id(other_id) != 0;
+            return !touches_run;
+        });
+        if (touches_run) {
+            std::vector<std::tuple<uint64_t, bool, bool, bool>> edges;
+            node->for_each_edge([&](uint64_t other_id, bool other_rev, bool to_curr, bool on_rev) {
+                const auto other = map_node(other_id, other_rev);
+                edges.push_back(std::make_tuple(other.first, other.second, to_curr, on_rev));
+                return true;
+            });
+            node->clear_edges();
+            for (auto& e : edges) {
+                node->add_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e), std::get<3>(e));
+            }
+        }
+        const uint64_t n_steps = node->path_count();
+        for (uint64_t r = 0; r < n_steps; ++r) {
+            const node_t::step_t step = node->get_path_step(r);
+            if (step.path_id == 0) {
+                continue;
+            }
+            if (!step.is_start && run_of_id(step.prev_id)) {
+                const auto prev = map_step(step.prev_id, step.prev_rank);
+                node->set_step_prev_id(r, prev.first);
+                node->set_step_prev_rank(r, prev.second);
+            }
+            if (!step.is_end && run_of_id(step.next_id)) {
+                const auto next = map_step(step.next_id, step.next_rank);
+                node->set_step_next_id(r, next.first);
+                node->set_step_next_rank(r, next.second);
+            }
+        }
+    }
+
+    // update the path ends and lengths
+    auto map_path_end = [&](step_handle_t step) {
+        const handle_t h = as_handle((uint64_t&)as_integers(step)[0]);
+        if (run_of_id(get_id(h))) {
+            const auto mapped = map_step(get_id(h), as_integers(step)[1]);
+            const bool is_rev = get_is_reverse(h) != (bool)run_rev[number_bool_packing::unpack_number(h)];
+            as_integers(step)[0] = as_integer(get_handle(mapped.first, is_rev));
+            as_integers(step)[1] = mapped.second;
+        }
+        return step;
+    };
+    for (uint64_t i = 1; i <= _path_handle_next; ++i) {
+        path_metadata_t* p = path_metadata_v.get(i);
+        if (p == nullptr || p->length == 0) {
+            continue;
+        }
+        p->length -= removed_steps[i];
+        p->first.store(map_path_end(p->first.load()));
+        p->last.store(map_path_end(p->last.load()));
+    }
+
+    // remove the nodes of the runs
+    uint64_t internal_edges = 0;
+    std::vector<std::vector<handle_t>> merged(runs.size());
+    for (uint64_t i = 0; i < runs.size(); ++i) {
+        if (!mergeable[i]) {
+            merged[i] = runs[i];
+            continue;
+        }
+        internal_edges += runs[i].size() - 1;
+        for (auto& h : runs[i]) {
+            const uint64_t rank = number_bool_packing::unpack_number(h);
+            delete node_v[rank];
+            node_v[rank] = nullptr;
+            deleted_nodes.insert(rank + 1);
+        }
+        merged[i].push_back(number_bool_packing::pack(run_rank[i], false));
+    }
+    _edge_count -= internal_edges;
+    return merged;
+}
+
 /**
  * This is the interface for a handle graph with embedded paths where the paths can be modified.
  * Note that if the *graph* can also be modified, the implementation will also
@@ -1205,7 +1767,7 @@ void graph_t::destroy_path(const path_handle_t& path) {
     auto& p = get_path_metadata(path);
     // our length should be 0
     assert(p.length == 0);
-    path_metadata_h->Delete(as_integer(p.handle));
+    path_metadata_v.set(as_integer(p.handle), nullptr);
     path_name_h->Delete(p.name);
     delete &p;
     --_path_count;
@@ -1231,7 +1793,7 @@ path_handle_t graph_t::create_path_handle(const std::string& name, bool is_circu
     p.name = name;
     p.is_circular = is_circular;
     ++_path_count; // atomic
-    path_metadata_h->Insert(as_integer(path), _p);
+    path_metadata_v.set(as_integer(path), _p);
     path_name_h->Insert(name, _p);
     auto& q = path_metadata(path);
     return path;
@@ -1540,58 +2102,139 @@ void graph_t::display() const {
 
 }
 
-void graph_t::to_gfa(std::ostream& out, const bool& emit_node_annotation) const {
-    out << "H\tVN:Z:1.0" << std::endl;
-    // for each node
-    for_each_handle([&out,&emit_node_annotation, this](const handle_t& h) {
-            out << "S\t" << get_id(h) << "\t" << get_sequence(h);
-            if (emit_node_annotation) {
-                out << "\t"
-                << "DP:i:" << get_step_count(h) << "\t"
-                << "RC:i:" << get_step_count(h) * get_length(h);
+/// Append the decimal representation of v to buf, without going through iostreams.
+static inline void append_uint(std::string& buf, uint64_t v) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = '0' + v % 10;
+        v /= 10;
+    } while (v);
+    while (n) {
+        buf.push_back(digits[--n]);
+    }
+}
+
+void graph_t::to_gfa(std::ostream& out, const bool& emit_node_annotation, const uint64_t& nthreads) const {
+    const uint64_t nodes_per_chunk = 1 << 12;
+    const uint64_t steps_per_chunk = 1 << 16;
+
+    // a chunk is either a run of node ranks, or a run of steps of a path
+    struct gfa_chunk_t {
+        bool is_path;
+        uint64_t begin;        // first node rank, or index of the first step in the path
+        uint64_t end;
+        path_handle_t path;
+        step_handle_t step;    // first step of the run
+        bool last;             // the run closes the path line
+    };
+    std::vector<gfa_chunk_t> chunks;
+    for (uint64_t i = 0; i < node_v.size(); i += nodes_per_chunk) {
+        chunks.push_back({false, i, std::min(i + nodes_per_chunk, (uint64_t)node_v.size()), as_path_handle(0), step_handle_t(), false});
+    }
+
+    // find where each path is cut into runs, walking the paths in parallel
+    std::vector<path_handle_t> paths;
+    for_each_path_handle([&](const path_handle_t& p) { paths.push_back(p); });
+    std::vector<std::vector<step_handle_t>> path_cuts(paths.size());
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+    for (uint64_t i = 0; i < paths.size(); ++i) {
+        uint64_t j = 0;
+        for_each_step_in_path(paths[i], [&](const step_handle_t& step) {
+            if (j++ % steps_per_chunk == 0) {
+                path_cuts[i].push_back(step);
             }
-            out << std::endl;
+        });
+    }
+    for (uint64_t i = 0; i < paths.size(); ++i) {
+        auto& cuts = path_cuts[i];
+        const uint64_t n_steps = get_step_count(paths[i]);
+        if (cuts.empty()) {
+            chunks.push_back({true, 0, 0, paths[i], path_begin(paths[i]), true});
+        }
+        for (uint64_t k = 0; k < cuts.size(); ++k) {
+            const uint64_t begin = k * steps_per_chunk;
+            chunks.push_back({true, begin, std::min(begin + steps_per_chunk, n_steps), paths[i], cuts[k], k + 1 == cuts.size()});
+        }
+        std::vector<step_handle_t>().swap(cuts);
+    }
 
-            {
+    auto format_chunk = [&](const gfa_chunk_t& chunk, std::string& buf) {
+        if (!chunk.is_path) {
+            for (uint64_t i = chunk.begin; i < chunk.end; ++i) {
+                const handle_t h = number_bool_packing::pack(i, false);
+                if (is_deleted(h)) continue;
+                const nid_t node_id = get_id(h);
+                buf.append("S\t");
+                append_uint(buf, node_id);
+                buf.push_back('\t');
+                buf.append(get_sequence(h));
+                if (emit_node_annotation) {
+                    buf.append("\tDP:i:");
+                    append_uint(buf, get_step_count(h));
+                    buf.append("\tRC:i:");
+                    append_uint(buf, get_step_count(h) * get_length(h));
+                }
+                buf.push_back('\n');
                 // use this direct iteration to avoid double counting edges
                 // we only consider write the edges relative to their start
                 const node_t& node = get_node_cref(h);
-                bool is_rev = get_is_reverse(h);
-                nid_t node_id = get_id(h);
                 node.for_each_edge(
                     [&](nid_t other_id,
                         bool other_rev,
                         bool to_curr,
                         bool on_rev) {
                         if (!to_curr) {
-                            out << "L\t" << node_id << "\t"
-                                << (on_rev?"-":"+") << "\t"
-                                << other_id << "\t"
-                                << (other_rev?"-":"+") << "\t"
-                                << "0M" << std::endl;
+                            buf.append("L\t");
+                            append_uint(buf, node_id);
+                            buf.append(on_rev ? "\t-\t" : "\t+\t");
+                            append_uint(buf, other_id);
+                            buf.append(other_rev ? "\t-\t0M\n" : "\t+\t0M\n");
                         }
                         return true;
                     });
             }
-        });
-    for_each_path_handle([&out,this](const path_handle_t& p) {
-            out << "P\t" << get_path_name(p) << "\t";
-            auto& path_meta = path_metadata(p);
-            uint64_t i = 0;
-            for_each_step_in_path(p, [this,&i,&out](const step_handle_t& step) {
-                    handle_t h = get_handle_of_step(step);
-                    out << get_id(h) << (get_is_reverse(h)?"-":"+");
-                    if (has_next_step(step)) out << ",";
-                    ++i;
-                });
-            out << "\t" << "*"; // always put at least a "*" in the overlaps field
-            if (get_is_circular(p)) {
-                out << "\t" << "TP:Z:circular";
+        } else {
+            if (chunk.begin == 0) {
+                buf.append("P\t");
+                buf.append(get_path_name(chunk.path));
+                buf.push_back('\t');
             }
-            assert(i == path_meta.length);
-            //out << "\t" << "steps:i:" << path_meta.length;
-            out << std::endl;
-        });
+            step_handle_t step = chunk.step;
+            for (uint64_t i = chunk.begin; i < chunk.end; ++i) {
+                if (i > 0) buf.push_back(',');
+                const handle_t h = get_handle_of_step(step);
+                append_uint(buf, get_id(h));
+                buf.push_back(get_is_reverse(h) ? '-' : '+');
+                step = get_next_step(step);
+            }
+            if (chunk.last) {
+                buf.append("\t*"); // always put at least a "*" in the overlaps field
+                if (get_is_circular(chunk.path)) {
+                    buf.append("\tTP:Z:circular");
+                }
+                buf.push_back('\n');
+            }
+        }
+    };
+
+    out << "H\tVN:Z:1.0\n";
+    // format a batch of chunks in parallel, then write it in order, so that memory stays bounded
+    const uint64_t batch_size = std::max((uint64_t)1, nthreads) * 16;
+    std::vector<std::string> buffers(batch_size);
+    for (uint64_t batch_begin = 0; batch_begin < chunks.size(); batch_begin += batch_size) {
+        const uint64_t batch_end = std::min(batch_begin + batch_size, (uint64_t)chunks.size());
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+        for (uint64_t i = batch_begin; i < batch_end; ++i) {
+            auto& buf = buffers[i - batch_begin];
+            buf.clear();
+            format_chunk(chunks[i], buf);
+        }
+        for (uint64_t i = batch_begin; i < batch_end; ++i) {
+            out.write(buffers[i - batch_begin].data(), buffers[i - batch_begin].size());
+        }
+    }
+    out.flush();
 }
 
 uint32_t graph_t::get_magic_number() const {
@@ -1684,7 +2327,7 @@ void graph_t::deserialize_members(std::istream& in) {
         char n[s+1]; n[s] = '\0';
         in.read(n,s);
         m.name = string(n);
-        path_metadata_h->Insert(as_integer(m.handle), _p);
+        path_metadata_v.set(as_integer(m.handle), _p);
         path_name_h->Insert(m.name, _p);
     }
 }
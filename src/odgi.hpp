@@ -14,6 +14,8 @@
 #include <utility>
 #include <functional>
 #include <thread>
+#include <type_traits>
+#include <iterator>
 #include <handlegraph/types.hpp>
 #include <handlegraph/iteratee.hpp>
 #include <handlegraph/util.hpp>
@@ -28,6 +30,7 @@
 #include "dynamic.hpp"
 #include "dynamic_types.hpp"
 #include "lockfree_hashtable.hpp"
+#include "atomic_pointer_table.hpp"
 #include "dna.hpp"
 #include "hash_map.hpp"
 #include "node.hpp"
@@ -43,14 +46,23 @@ using namespace handlegraph;
 // Resolve ambiguous nid_t typedef by putting it in our namespace.
 using nid_t = handlegraph::nid_t;
 
+/// Call an iteratee of the fast iteration functions, which may return void (keep going) or bool (false to stop).
+template<typename Iteratee, typename... Args>
+inline bool call_fast_iteratee(Iteratee& iteratee, Args&&... args) {
+    if constexpr (std::is_void<std::invoke_result_t<Iteratee&, Args...>>::value) {
+        iteratee(std::forward<Args>(args)...);
+        return true;
+    } else {
+        return iteratee(std::forward<Args>(args)...);
+    }
+}
+
 class graph_t : public MutablePathDeletableHandleGraph, public SerializableHandleGraph, public RankedHandleGraph {
 
 public:
 
     graph_t(void) {
         // set up initial delimiters
-        path_metadata_h = std::make_unique<lockfree::LockFreeHashTable<uint64_t,
-                                                                       path_metadata_t*>>();
         path_name_h = std::make_unique<lockfree::LockFreeHashTable<std::string,
                                                                    path_metadata_t*>>();
         _edge_count = 0;
@@ -249,6 +261,151 @@ public:
     /// Returns true if the path is circular
     bool get_is_circular(const path_handle_t& path_handle) const;
 
+    /// Inlineable versions of the iteration functions, for hot loops. The iteratee is a template parameter rather
+    /// than a std::function and may return void, or bool to stop early by returning false. They return false if
+    /// they stopped early.
+
+    /// Loop over all the handles to next/previous (right/left) nodes, as follow_edges.
+    template<typename Iteratee>
+    bool follow_edges_fast(const handle_t& handle, bool go_left, Iteratee&& iteratee) const {
+        const nid_t id_increment = _id_increment;
+        const nid_t node_id = number_bool_packing::unpack_number(handle) + 1 + id_increment;
+        const bool is_rev = number_bool_packing::unpack_bit(handle);
+        bool flag = true;
+        node_v[number_bool_packing::unpack_number(handle)]->for_each_edge_fast(
+            [&](uint64_t other_id, bool other_rev, bool to_curr, bool on_rev) {
+                if ((nid_t)other_id == node_id && on_rev == other_rev) {
+                    // non-inverting self loop
+                    to_curr = go_left;
+                    other_rev = is_rev;
+                } else if (is_rev != on_rev) {
+                    other_rev = !other_rev;
+                    to_curr = !to_curr;
+                }
+                if (go_left == to_curr) {
+                    flag = call_fast_iteratee(iteratee, number_bool_packing::pack(other_id - id_increment - 1, other_rev));
+                }
+                return flag;
+            });
+        return flag;
+    }
+
+    /// Loop over all the nodes in the graph in their local forward orientations, as for_each_handle.
+    template<typename Iteratee>
+    bool for_each_handle_fast(Iteratee&& iteratee, bool parallel = false) const {
+        const uint64_t n = node_v.size();
+        if (parallel) {
+            volatile bool flag = true;
+#pragma omp parallel for
+            for (uint64_t i = 0; i < n; ++i) {
+                if (node_v[i] == nullptr || !flag) continue;
+                bool result = call_fast_iteratee(iteratee, number_bool_packing::pack(i, false));
+#pragma omp atomic
+                flag &= result;
+            }
+            return flag;
+        } else {
+            for (uint64_t i = 0; i < n; ++i) {
+                if (node_v[i] == nullptr) continue;
+                if (!call_fast_iteratee(iteratee, number_bool_packing::pack(i, false))) return false;
+            }
+            return true;
+        }
+    }
+
+    /// Loop over every edge of the graph once, as for_each_edge.
+    template<typename Iteratee>
+    bool for_each_edge_fast(Iteratee&& iteratee, bool parallel = false) const {
+        return for_each_handle_fast([&](const handle_t& handle) {
+            const uint64_t rank = number_bool_packing::unpack_number(handle);
+            // edges to nodes of higher rank, or rightward self loops
+            bool keep_going = follow_edges_fast(handle, false, [&](const handle_t& next) {
+                if (rank <= number_bool_packing::unpack_number(next)) {
+                    return call_fast_iteratee(iteratee, edge_t(handle, next));
+                }
+                return true;
+            });
+            if (keep_going) {
+                // edges from nodes of higher rank, or leftward reversing self loops
+                keep_going = follow_edges_fast(handle, true, [&](const handle_t& prev) {
+                    const uint64_t prev_rank = number_bool_packing::unpack_number(prev);
+                    if (rank < prev_rank || (rank == prev_rank && !number_bool_packing::unpack_bit(prev))) {
+                        return call_fast_iteratee(iteratee, edge_t(prev, handle));
+                    }
+                    return true;
+                });
+            }
+            return keep_going;
+        }, parallel);
+    }
+
+    /// Enumerate the path steps on a given handle (strand agnostic), as for_each_step_on_handle.
+    template<typename Iteratee>
+    bool for_each_step_on_handle_fast(const handle_t& handle, Iteratee&& iteratee) const {
+        const uint64_t handle_n = number_bool_packing::unpack_number(handle);
+        bool flag = true;
+        node_v[handle_n]->for_each_path_step_fast(
+            [&](uint64_t rank, uint64_t path_id, bool is_rev) {
+                step_handle_t step_handle;
+                as_integers(step_handle)[0] = as_integer(number_bool_packing::pack(handle_n, is_rev));
+                as_integers(step_handle)[1] = rank;
+                flag = call_fast_iteratee(iteratee, step_handle);
+                return flag;
+            });
+        return flag;
+    }
+
+    /// Decode the handles to next/previous (right/left) nodes into buffer, which is cleared first.
+    /// Returns their number.
+    size_t get_edges(const handle_t& handle, bool go_left, std::vector<handle_t>& buffer) const;
+
+    /// Decode the path steps on a given handle into buffer, which is cleared first. Returns their number.
+    size_t get_steps_on_handle(const handle_t& handle, std::vector<step_handle_t>& buffer) const;
+
+    /// A forward iterator over the steps of a path, from first through last, as for_each_step_in_path.
+    class path_step_iterator_t {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = step_handle_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const step_handle_t*;
+        using reference = const step_handle_t&;
+
+        path_step_iterator_t(const graph_t* graph, const step_handle_t& step, const step_handle_t& back)
+            : graph(graph), step(step), back(back) { }
+        inline reference operator*() const { return step; }
+        inline pointer operator->() const { return &step; }
+        inline path_step_iterator_t& operator++() {
+            // in circular paths, we'll always have a next step, so we stop at the path's last step
+            step = (step == back || !graph->has_next_step(step))
+                ? graph->path_end(graph->get_path_handle_of_step(step))
+                : graph->get_next_step(step);
+            return *this;
+        }
+        inline path_step_iterator_t operator++(int) {
+            path_step_iterator_t prev = *this;
+            ++(*this);
+            return prev;
+        }
+        inline bool operator==(const path_step_iterator_t& other) const { return step == other.step; }
+        inline bool operator!=(const path_step_iterator_t& other) const { return step != other.step; }
+    private:
+        const graph_t* graph;
+        step_handle_t step;
+        step_handle_t back;
+    };
+
+    /// The steps of a path, for use in range-based for loops.
+    struct path_steps_t {
+        path_step_iterator_t first;
+        path_step_iterator_t last;
+        inline path_step_iterator_t begin() const { return first; }
+        inline path_step_iterator_t end() const { return last; }
+    };
+
+    /// Return the steps of a path from first through last, as for_each_step_in_path.
+    path_steps_t steps_of_path(const path_handle_t& path) const;
+
     /// Set if the path is circular or not
     void set_circularity(const path_handle_t& path_handle, bool circular);
 
@@ -346,8 +503,31 @@ public:
         return std::make_pair(parts.front(), parts.back());
     }
 
+    /// Split many nodes at once, each at the given offsets in its handle's
+    /// orientation, as divide_handle. The nodes are divided in parallel,
+    /// each rewriting its own edges and path steps, so no locking is needed.
+    /// The pieces get new ids above the current maximum. Returns for each
+    /// division the handles to its parts, in the order and orientation of
+    /// the handle passed in. The handles must be of distinct nodes.
+    /// Updates stored paths.
+    std::vector<std::vector<handle_t>> divide_handles(
+        const std::vector<std::pair<handle_t, std::vector<size_t>>>& divisions);
+
     handle_t combine_handles(const std::vector<handle_t>& handles);
 
+    /// Merge many runs of handles at once, each into a single new node, as
+    /// found by algorithms::simple_components: the handles of a run are in
+    /// left to right order, consecutive handles are joined by the only edge
+    /// on those sides, and every path visiting the run goes through it from
+    /// end to end. The runs are merged in parallel, each node rewriting its
+    /// own edges and path steps, so no locking is needed. The new nodes get
+    /// ids above the current maximum. A run on which a path starts or ends
+    /// anywhere but at its ends is left as it is. Returns for each run the
+    /// forward handle of its new node, or its handles if it was not merged.
+    /// The runs must be disjoint and have at least two handles. Updates
+    /// stored paths.
+    std::vector<std::vector<handle_t>> combine_handle_runs(const std::vector<std::vector<handle_t>>& runs);
+
 /**
  * This is the interface for a handle graph with embedded paths where the paths can be modified.
  * Note that if the *graph* can also be modified, the implementation will also
@@ -402,8 +582,9 @@ public:
     /// A helper function to visualize the state of the graph
     void display(void) const;
 
-    /// Convert to GFA (for debugging)
-    void to_gfa(std::ostream& out, const bool& emit_node_annotation = false) const;
+    /// Convert to GFA. The S/L lines of runs of nodes and the P lines of runs of path steps are
+    /// formatted in parallel into per-chunk buffers, which are written in the usual order.
+    void to_gfa(std::ostream& out, const bool& emit_node_annotation = false, const uint64_t& nthreads = 1) const;
 
     /// Magic number header for serialization
     uint32_t get_magic_number(void) const;
@@ -477,7 +658,8 @@ public:
     };
 
     /// maps between path identifier and the start, end, and length of the path
-    std::unique_ptr<lockfree::LockFreeHashTable<uint64_t, path_metadata_t*>> path_metadata_h;
+    /// path handles are dense integers below _path_handle_next, so the metadata is found by direct indexing
+    atomic_pointer_table_t<path_metadata_t> path_metadata_v;
     std::unique_ptr<lockfree::LockFreeHashTable<std::string, path_metadata_t*>> path_name_h;
     path_metadata_t& get_path_metadata(const path_handle_t& path) const;
     const path_metadata_t& path_metadata(const path_handle_t& path) const;
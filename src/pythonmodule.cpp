@@ -1,15 +1,36 @@
 // odgi
 #include "odgi.hpp"
+#include "algorithms/layout.hpp"
 
 // Pybind11
 #include <pybind11/pybind11.h>
 #include <pybind11/functional.h>
 #include <pybind11/iostream.h>
+#include <pybind11/numpy.h>
+
+#include <fstream>
+#include <stdexcept>
 
 namespace py = pybind11;
 
 using namespace odgi;
 
+/// Hand a vector over to NumPy without copying its data: the array keeps the vector alive through a capsule.
+template<typename T>
+py::array as_numpy(std::vector<T>&& v, const std::vector<py::ssize_t>& shape, const py::dtype& dtype = py::dtype::of<T>()) {
+    auto* owned = new std::vector<T>(std::move(v));
+    py::capsule owner(owned, [](void* p) { delete reinterpret_cast<std::vector<T>*>(p); });
+    return py::array(dtype, shape, std::vector<py::ssize_t>(), owned->data(), owner);
+}
+
+/// The handles of the graph in for_each_handle order, which is the order of the bulk node arrays.
+std::vector<handlegraph::handle_t> node_handles(const odgi::graph_t& g) {
+    std::vector<handlegraph::handle_t> handles;
+    handles.reserve(g.get_node_count());
+    g.for_each_handle_fast([&](const handlegraph::handle_t& h) { handles.push_back(h); });
+    return handles;
+}
+
 PYBIND11_MODULE(odgi, m)
 {
 
@@ -316,7 +337,121 @@ PYBIND11_MODULE(odgi, m)
                  g.deserialize(in);
              },
              "Load the graph from the given file.")
+        // Bulk accessors returning NumPy arrays. They release the GIL while they collect the data, and the arrays
+        // take over the collected buffers rather than copying them.
+        .def("node_ids",
+             [](const odgi::graph_t& g) {
+                 std::vector<int64_t> ids;
+                 {
+                     py::gil_scoped_release release;
+                     const std::vector<handlegraph::handle_t> handles = node_handles(g);
+                     ids.resize(handles.size());
+#pragma omp parallel for schedule(static)
+                     for (uint64_t i = 0; i < handles.size(); ++i) {
+                         ids[i] = g.get_id(handles[i]);
+                     }
+                 }
+                 const py::ssize_t n = ids.size();
+                 return as_numpy(std::move(ids), {n});
+             },
+             "Return the ids of all nodes as an int64 array, in the order of for_each_handle.")
+        .def("node_lengths",
+             [](const odgi::graph_t& g) {
+                 std::vector<uint64_t> lengths;
+                 {
+                     py::gil_scoped_release release;
+                     const std::vector<handlegraph::handle_t> handles = node_handles(g);
+                     lengths.resize(handles.size());
+#pragma omp parallel for schedule(static)
+                     for (uint64_t i = 0; i < handles.size(); ++i) {
+                         lengths[i] = g.get_length(handles[i]);
+                     }
+                 }
+                 const py::ssize_t n = lengths.size();
+                 return as_numpy(std::move(lengths), {n});
+             },
+             "Return the lengths of all nodes as a uint64 array, in the order of node_ids.")
+        .def("node_depths",
+             [](const odgi::graph_t& g) {
+                 std::vector<uint64_t> depths;
+                 {
+                     py::gil_scoped_release release;
+                     const std::vector<handlegraph::handle_t> handles = node_handles(g);
+                     depths.resize(handles.size());
+#pragma omp parallel for schedule(dynamic, 1024)
+                     for (uint64_t i = 0; i < handles.size(); ++i) {
+                         uint64_t depth = 0;
+                         g.for_each_step_on_handle_fast(handles[i], [&](const handlegraph::step_handle_t& s) { ++depth; });
+                         depths[i] = depth;
+                     }
+                 }
+                 const py::ssize_t n = depths.size();
+                 return as_numpy(std::move(depths), {n});
+             },
+             "Return the number of path steps on each node as a uint64 array, in the order of node_ids.")
+        .def("edges",
+             [](const odgi::graph_t& g) {
+                 std::vector<int64_t> edges;
+                 {
+                     py::gil_scoped_release release;
+                     g.for_each_edge_fast([&](const handlegraph::edge_t& e) {
+                         edges.push_back(g.get_id(e.first));
+                         edges.push_back(g.get_is_reverse(e.first));
+                         edges.push_back(g.get_id(e.second));
+                         edges.push_back(g.get_is_reverse(e.second));
+                     });
+                 }
+                 const py::ssize_t m = edges.size() / 4;
+                 return as_numpy(std::move(edges), {m, 4});
+             },
+             "Return all edges as an int64 array with one row per edge and the columns\nfrom id, from is_reverse, to id, to is_reverse.")
+        .def("path_steps",
+             [](const odgi::graph_t& g, const handlegraph::path_handle_t& path) {
+                 std::vector<int64_t> ids;
+                 std::vector<uint8_t> is_rev;
+                 {
+                     py::gil_scoped_release release;
+                     const uint64_t n = g.get_step_count(path);
+                     ids.reserve(n);
+                     is_rev.reserve(n);
+                     for (auto& step : g.steps_of_path(path)) {
+                         const handlegraph::handle_t h = g.get_handle_of_step(step);
+                         ids.push_back(g.get_id(h));
+                         is_rev.push_back(g.get_is_reverse(h));
+                     }
+                 }
+                 const py::ssize_t n = ids.size();
+                 return py::make_tuple(as_numpy(std::move(ids), {n}),
+                                       as_numpy(std::move(is_rev), {n}, py::dtype::of<bool>()));
+             },
+             "Return the node ids (int64) and orientations (bool) of the steps of the given path, as two arrays.",
+             py::arg("path_handle"))
         // Definition of class_<odgi::graph_t> ends here.
     ;
 
+    m.def("load_layout",
+          [](const std::string& file) {
+              std::ifstream in(file.c_str());
+              if (!in.is_open()) {
+                  throw std::runtime_error("cannot open the layout file '" + file + "'");
+              }
+              std::vector<double> xy;
+              {
+                  py::gil_scoped_release release;
+                  odgi::algorithms::layout::Layout layout;
+                  layout.load(in);
+                  const uint64_t n = layout.size();
+                  xy.resize(2 * n);
+#pragma omp parallel for schedule(static)
+                  for (uint64_t i = 0; i < n; ++i) {
+                      xy[2 * i] = layout.get_x(i);
+                      xy[2 * i + 1] = layout.get_y(i);
+                  }
+              }
+              const py::ssize_t n = xy.size() / 2;
+              return as_numpy(std::move(xy), {n, 2});
+          },
+          "Load the 2D layout in the given .lay file as a float64 array with one (X, Y) row per point.\nRows 2*i and 2*i+1 are the start and end of the node of rank i.\nRaises RuntimeError if the file cannot be opened.",
+          py::arg("file"));
+
 }
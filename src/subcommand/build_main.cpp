@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <filesystem>
 #include "algorithms/topological_sort.hpp"
+#include "algorithms/instrumentation.hpp"
 
 namespace odgi {
 
@@ -74,7 +75,9 @@ int main_build(int argc, char** argv) {
             return 1;
         }
         if (!gfa_filename.empty()) {
+            algorithms::instrumentation::Phase phase("parse_gfa");
             gfa_to_handle(gfa_filename, &graph, args::get(optimize), args::get(nthreads), args::get(progress));
+            phase.add_items(graph.get_node_count());
         }
     }
 
@@ -82,14 +85,17 @@ int main_build(int argc, char** argv) {
     graph.set_number_of_threads(num_threads);
 
     if (args::get(toposort)) {
+        algorithms::instrumentation::Phase phase("topological_sort");
         graph.apply_ordering(algorithms::topological_order(&graph, true, args::get(progress)), true);
+        phase.add_items(graph.get_node_count());
     }
-    // here we should measure memory usage etc.
     if (args::get(debug)) {
         graph.display();
     }
     const std::string outfile = args::get(dg_out_file);
     if (!outfile.empty()) {
+        algorithms::instrumentation::Phase phase("write");
+        phase.add_items(graph.get_node_count());
         if (outfile == "-") {
             graph.serialize(std::cout);
         } else {
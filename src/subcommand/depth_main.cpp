@@ -5,6 +5,7 @@
 #include "split.hpp"
 #include "algorithms/bfs.hpp"
 #include "algorithms/depth.hpp"
+#include "algorithms/depth_index.hpp"
 #include "algorithms/path_length.hpp"
 #include <omp.h>
 
@@ -81,6 +82,17 @@ namespace odgi {
                                                  " When TIPS=1, retain only tips.",
                                                  {'W', "windows-out"});
 
+        args::Group depth_index_opts(parser, "[ Depth Index Options ]");
+        args::ValueFlag<std::string> _depth_index_out(depth_index_opts, "FILE",
+                                                      "Precompute the node depths and the per-path prefix sums of the base-weighted depth, "
+                                                      "and write this depth index to FILE. The file name usually ends with *.dpidx* (e.g. *INPUT_GRAPH.dpidx*). "
+                                                      "If no query is given, the program exits after writing the index.",
+                                                      {'X', "write-depth-index"});
+        args::ValueFlag<std::string> _depth_index(depth_index_opts, "FILE",
+                                                  "Load the depth index from this FILE and use it to answer node, path position, and path range queries "
+                                                  "without walking the paths. The depth index must be built from the same graph.",
+                                                  {'I', "depth-index"});
+
         args::Group threading_opts(parser, "[ Threading ] ");
         args::ValueFlag<uint64_t> _num_threads(threading_opts, "N", "Number of threads to use in parallel operations.", {'t', "threads"});
 		args::Group processing_info_opts(parser, "[ Processing Information ]");
@@ -132,6 +144,17 @@ namespace odgi {
 
         bool windows_only_tips = windows_in_only_tips || windows_out_only_tips;
 
+        if (_depth_index && _depth_index_out) {
+            std::cerr << "[odgi::depth] error: please specify -I/--depth-index or -X/--write-depth-index, not both." << std::endl;
+            return 1;
+        }
+
+        if (_depth_index && _subset_paths) {
+            std::cerr << "[odgi::depth] error: the depth index already encodes the paths considered at its construction, "
+                         "-s/--subset-paths can not be used together with -I/--depth-index." << std::endl;
+            return 1;
+        }
+
 		const uint64_t num_threads = args::get(_num_threads) ? args::get(_num_threads) : 1;
 
 		odgi::graph_t graph;
@@ -174,6 +197,27 @@ namespace odgi {
             paths_to_consider.resize(graph.get_path_count() + 1, true);
         }
 
+        std::unique_ptr<algorithms::depth_index_t> depth_index;
+        if (_depth_index) {
+            depth_index = std::make_unique<algorithms::depth_index_t>();
+            depth_index->load(args::get(_depth_index));
+            if (!depth_index->is_compatible(graph)) {
+                std::cerr << "[odgi::depth] error: the depth index " << args::get(_depth_index)
+                          << " was not built from the given graph." << std::endl;
+                return 1;
+            }
+        } else if (_depth_index_out) {
+            depth_index = std::make_unique<algorithms::depth_index_t>(
+                graph, _subset_paths ? paths_to_consider : std::vector<bool>(), num_threads, args::get(progress));
+            depth_index->save(args::get(_depth_index_out));
+            const bool any_query = summarize_depth || graph_depth_table || graph_depth_vec || path_depth || self_depth
+                || graph_pos || graph_pos_file || path_pos || path_pos_file || bed_input || path_name || path_file
+                || _windows_in || _windows_out;
+            if (!any_query) {
+                return 0;
+            }
+        }
+
         // these options are exclusive (probably we should say with a warning)
         std::vector<odgi::pos_t> graph_positions;
         std::vector<odgi::path_pos_t> path_positions;
@@ -437,7 +481,9 @@ namespace odgi {
             graph.for_each_handle(
                 [&](const handle_t& h) {
                     auto id = graph.get_id(h);
-                    depths[id - shift] = get_graph_node_depth(graph, id, paths_to_consider).first;
+                    depths[id - shift] = depth_index
+                        ? depth_index->get_node_depth(id)
+                        : get_graph_node_depth(graph, id, paths_to_consider).first;
                 }, true);
 
             auto in_bounds =
@@ -474,7 +520,9 @@ namespace odgi {
             graph.for_each_handle(
                 [&](const handle_t& h) {
                     const nid_t node_id = graph.get_id(h);
-                    const auto d = get_graph_node_depth(graph, node_id, paths_to_consider);
+                    const auto d = depth_index
+                        ? std::make_pair(depth_index->get_node_depth(node_id), depth_index->get_node_depth_uniq(node_id))
+                        : get_graph_node_depth(graph, node_id, paths_to_consider);
                     step_count += d.first;
                     ++node_count;
                     const auto l = graph.get_length(graph.get_handle(node_id));
@@ -494,7 +542,9 @@ namespace odgi {
 #pragma omp parallel for schedule(dynamic, 1)
             for (auto &pos : graph_positions) {
                 const nid_t node_id = id(pos);
-                const auto depth = get_graph_node_depth(graph, node_id, paths_to_consider);
+                const auto depth = depth_index
+                    ? std::make_pair(depth_index->get_node_depth(node_id), depth_index->get_node_depth_uniq(node_id))
+                    : get_graph_node_depth(graph, node_id, paths_to_consider);
 
 #pragma omp critical (cout)
                 std::cout << node_id << "\t"
@@ -507,6 +557,22 @@ namespace odgi {
             std::cout << "#path.position\tdepth\tdepth.uniq" << std::endl;
 #pragma omp parallel for schedule(dynamic, 1)
             for (auto &path_pos : path_positions) {
+                if (depth_index) {
+                    const nid_t node_id = depth_index->get_node_at(path_pos.path, path_pos.offset);
+                    if (node_id == 0) {
+#pragma omp critical (cout)
+                        std::cerr << "[odgi::depth] warning: position " << graph.get_path_name(path_pos.path) << ":" << path_pos.offset
+                                  << " outside of path" << std::endl;
+                        continue;
+                    }
+#pragma omp critical (cout)
+                    std::cout << (graph.get_path_name(path_pos.path)) << "," << path_pos.offset << ","
+                              << (path_pos.is_rev ? "-" : "+") << "\t"
+                              << depth_index->get_node_depth(node_id) << "\t"
+                              << depth_index->get_node_depth_uniq(node_id) << std::endl;
+                    continue;
+                }
+
                 const pos_t pos = get_graph_pos(graph, path_pos);
 
                 const nid_t node_id = id(pos);
@@ -519,7 +585,23 @@ namespace odgi {
             }
         }
 
-        if (!path_ranges.empty()) {
+        if (!path_ranges.empty() && depth_index) {
+            std::cout << "#path\tstart\tend\tmean.depth" << std::endl;
+            // each range is two binary searches, so we answer them all in bulk and write them in input order
+            std::vector<double> range_depths(path_ranges.size());
+#pragma omp parallel for schedule(static)
+            for (uint64_t i = 0; i < path_ranges.size(); ++i) {
+                range_depths[i] = depth_index->get_mean_depth(path_ranges[i]);
+            }
+            for (uint64_t i = 0; i < path_ranges.size(); ++i) {
+                const auto& range = path_ranges[i];
+                std::cout << (graph.get_path_name(range.begin.path)) << "\t"
+                          << range.begin.offset << "\t"
+                          << range.end.offset << "\t"
+                          << range_depths[i] << "\n";
+            }
+            std::cout.flush();
+        } else if (!path_ranges.empty()) {
             std::cout << "#path\tstart\tend\tmean.depth" << std::endl;
             algorithms::for_each_path_range_depth(
                 graph,
@@ -46,6 +46,7 @@ int main_draw(int argc, char **argv) {
     args::ValueFlag<double> png_line_width(visualizations_opts, "N", "Line width (in approximate bp) (default 0.0).", {'w', "line-width"});
     //args::ValueFlag<double> png_line_overlay(parser, "N", "line width (in approximate bp) (default 10.0)", {'O', "line-overlay"});
     args::ValueFlag<double> png_path_line_spacing(visualizations_opts, "N", "Spacing between path lines in PNG layout (in approximate bp) (default 0.0).", {'S', "path-line-spacing"});
+    args::ValueFlag<uint64_t> png_supersample(visualizations_opts, "N", "Anti-alias the PNG rendering by drawing N x N samples per pixel (default: 1, no supersampling).", {'a', "supersample"});
     args::ValueFlag<std::string> _path_bed_file(visualizations_opts, "FILE",
                                                 "Color the nodes based on the input annotation in the given BED FILE. "
                                                 "Colors are derived from the 4th column, if present, else from the path name."
@@ -174,6 +175,7 @@ int main_draw(int argc, char **argv) {
     const double _png_line_width = png_line_width ? args::get(png_line_width) : 0;
     const bool _color_paths = args::get(color_paths);
     const double _png_path_line_spacing = png_path_line_spacing ? args::get(png_path_line_spacing) : 0.0;
+    const uint64_t _png_supersample = png_supersample ? std::max((uint64_t)1, args::get(png_supersample)) : 1;
     const double svg_scale = !render_scale ? 1.0 : args::get(render_scale);
     size_t max_node_depth = 0;
     graph.for_each_handle(
@@ -225,7 +227,8 @@ int main_draw(int argc, char **argv) {
         // todo could be done with callbacks
         std::vector<double> X = layout.get_X();
         std::vector<double> Y = layout.get_Y();
-        algorithms::draw_png(outfile, X, Y, graph, 1.0, border_bp, 0, _png_height, _png_line_width, _png_path_line_spacing, _color_paths, node_id_to_color);
+        algorithms::draw_png(outfile, X, Y, graph, 1.0, border_bp, 0, _png_height, _png_line_width, _png_path_line_spacing, _color_paths, node_id_to_color,
+                                num_threads, _png_supersample);
     }
     
     return 0;
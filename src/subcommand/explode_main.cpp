@@ -2,6 +2,8 @@
 
 #include "args.hxx"
 #include <queue>
+#include <sstream>
+#include <omp.h>
 #include <atomic_bitvector.hpp>
 #include "src/algorithms/subgraph/extract.hpp"
 
@@ -37,6 +39,11 @@ namespace odgi {
                                            {'s', "sorting-criteria"});
         args::Flag _optimize(explode_opts, "optimize", "Compact the node ID space in each connected component.",
                              {'O', "optimize"});
+        args::ValueFlag<std::string> _archive(explode_opts, "FILE",
+                                              "Write all connected components into this single archive *FILE* instead of one file per component. "
+                                              "The components are concatenated in ODGI (or GFAv1 with **-g, --to-gfa**) format, "
+                                              "and their byte ranges are indexed in `FILE.idx`.",
+                                              {'a', "archive"});
         args::Group threading_opts(parser, "[ Threading ]");
         args::ValueFlag<uint64_t> nthreads(threading_opts, "N",
                                            "Number of threads to use for parallel operations.",
@@ -92,19 +99,36 @@ namespace odgi {
             output_dir_plus_prefix += "component";
         }
 
-        std::vector<ska::flat_hash_set<handlegraph::nid_t>> weak_components =
-                algorithms::weakly_connected_components(&graph);
+        const std::string archive_filename = _archive ? args::get(_archive) : "";
 
+        uint64_t n_components = 0;
+        std::vector<handlegraph::nid_t> component_members;
+        std::vector<uint64_t> component_offsets;
+        {
+            const std::vector<uint64_t> component_ids =
+                    algorithms::weakly_connected_component_ids(graph, n_components, num_threads);
+            algorithms::weakly_connected_component_members(graph, component_ids, n_components,
+                                                           component_members, component_offsets);
+        }
+        // the node ids of a component are the range [begin, end) in component_members
+        auto component_begin = [&](const uint64_t& component_index) {
+            return component_members.begin() + component_offsets[component_index];
+        };
+        auto component_end = [&](const uint64_t& component_index) {
+            return component_members.begin() + component_offsets[component_index + 1];
+        };
 
-        atomicbitvector::atomic_bv_t ignore_component(weak_components.size());
+        atomicbitvector::atomic_bv_t ignore_component(n_components);
 
         if (_write_biggest_components && args::get(_write_biggest_components) > 0) {
             char size_metric = _size_metric ? args::get(_size_metric) : 'p';
 
-            auto get_path_handles = [](const graph_t &graph, const ska::flat_hash_set<handlegraph::nid_t> &node_ids,
+            auto get_path_handles = [](const graph_t &graph,
+                                       std::vector<handlegraph::nid_t>::const_iterator begin,
+                                       std::vector<handlegraph::nid_t>::const_iterator end,
                                        set<path_handle_t> &paths) {
-                for (auto node_id : node_ids) {
-                    handle_t handle = graph.get_handle(node_id);
+                for (auto it = begin; it != end; ++it) {
+                    handle_t handle = graph.get_handle(*it);
 
                     graph.for_each_step_on_handle(handle, [&](const step_handle_t &source_step) {
                         paths.insert(graph.get_path_handle_of_step(source_step));
@@ -121,16 +145,17 @@ namespace odgi {
             };
 
             std::vector<std::pair<uint64_t, uint64_t>> component_and_size;
-            component_and_size.resize(weak_components.size());
+            component_and_size.resize(n_components);
 
             // Fill the vector with component sizes
 #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
-            for (uint64_t component_index = 0; component_index < weak_components.size(); ++component_index) {
+            for (uint64_t component_index = 0; component_index < n_components; ++component_index) {
                 ignore_component.set(component_index);
 
                 component_and_size[component_index].first = component_index;
 
-                auto &weak_component = weak_components[component_index];
+                const auto begin = component_begin(component_index);
+                const auto end = component_end(component_index);
 
                 uint64_t size = 0;
 
@@ -138,8 +163,8 @@ namespace odgi {
                     case 'l': {
                         // graph length (number of node bases)
 
-                        for (auto node_id : weak_component) {
-                            size += graph.get_length(graph.get_handle(node_id));
+                        for (auto it = begin; it != end; ++it) {
+                            size += graph.get_length(graph.get_handle(*it));
                         }
 
                         break;
@@ -147,7 +172,7 @@ namespace odgi {
                     case 'n': {
                         // number of nodes
 
-                        size = weak_component.size();
+                        size = end - begin;
 
                         break;
                     }
@@ -155,7 +180,7 @@ namespace odgi {
                         // longest path",
 
                         set<path_handle_t> paths;
-                        get_path_handles(graph, weak_component, paths);
+                        get_path_handles(graph, begin, end, paths);
 
                         uint64_t current_path_len;
                         for (path_handle_t path_handle : paths) {
@@ -171,7 +196,7 @@ namespace odgi {
                         // p: path mass (total number of path bases)
 
                         set<path_handle_t> paths;
-                        get_path_handles(graph, weak_component, paths);
+                        get_path_handles(graph, begin, end, paths);
 
                         for (path_handle_t path_handle : paths) {
                             size += get_path_length(graph, path_handle);
@@ -207,40 +232,79 @@ namespace odgi {
         std::unique_ptr<algorithms::progress_meter::ProgressMeter> component_progress;
         if (progress) {
             component_progress = std::make_unique<algorithms::progress_meter::ProgressMeter>(
-                    weak_components.size(), "[odgi::explode] exploding component(s)");
+                    n_components, "[odgi::explode] exploding component(s)");
 
-            std::cerr << "[odgi::explode] detected " << weak_components.size() << " connected component(s)"
+            std::cerr << "[odgi::explode] detected " << n_components << " connected component(s)"
                       << std::endl;
 
             if (_write_biggest_components && args::get(_write_biggest_components) > 0) {
                 uint64_t write_biggest_components = args::get(_write_biggest_components);
 
                 std::cerr << "[odgi::explode] explode the "
-                          << (write_biggest_components <= weak_components.size() ? write_biggest_components
-                                                                                 : weak_components.size())
+                          << (write_biggest_components <= n_components ? write_biggest_components
+                                                                       : n_components)
                           << " biggest connected component(s)" << std::endl;
             }
         }
 
-        for (uint64_t component_index = 0; component_index < weak_components.size(); ++component_index) {
+        std::vector<uint64_t> components_to_write;
+        for (uint64_t component_index = 0; component_index < n_components; ++component_index) {
             if (!ignore_component.test(component_index)) {
-                auto &weak_component = weak_components[component_index];
-
-                graph_t subgraph;
+                components_to_write.push_back(component_index);
+            } else if (progress) {
+                component_progress->increment(1);
+            }
+        }
 
-                for (auto node_id : weak_component) {
-                    subgraph.create_handle(graph.get_sequence(graph.get_handle(node_id)), node_id);
-                }
+        const bool to_archive = !archive_filename.empty();
+        std::ofstream archive;
+        // (component, offset, length) of each component in the archive
+        std::vector<std::tuple<uint64_t, uint64_t, uint64_t>> archive_index;
+        if (to_archive) {
+            archive.open(archive_filename, std::ios::binary);
+            if (archive.fail()) {
+                std::cerr << "[odgi::explode] error: cannot write the archive to " << archive_filename << "." << std::endl;
+                return 1;
+            }
+            archive_index.reserve(components_to_write.size());
+        }
+        uint64_t archive_offset = 0;
+
+        // each worker extracts and writes one component at a time, so at most num_threads subgraphs are held in memory;
+        // when there are fewer components than threads, the threads go to the path extraction instead
+        const bool parallel_components = components_to_write.size() >= num_threads;
+        const uint64_t num_threads_per_component = parallel_components ? 1 : num_threads;
+#pragma omp parallel for schedule(dynamic, 1) num_threads(parallel_components ? num_threads : 1)
+        for (uint64_t i = 0; i < components_to_write.size(); ++i) {
+            const uint64_t component_index = components_to_write[i];
+            graph_t subgraph;
+
+            for (auto it = component_begin(component_index); it != component_end(component_index); ++it) {
+                subgraph.create_handle(graph.get_sequence(graph.get_handle(*it)), *it);
+            }
 
-                weak_component.clear();
+            algorithms::add_connecting_edges_to_subgraph(graph, subgraph);
+            algorithms::add_full_paths_to_component(graph, subgraph, num_threads_per_component);
 
-                algorithms::add_connecting_edges_to_subgraph(graph, subgraph);
-                algorithms::add_full_paths_to_component(graph, subgraph, num_threads);
+            if (optimize) {
+                subgraph.optimize();
+            }
 
-                if (optimize) {
-                    subgraph.optimize();
+            if (to_archive) {
+                std::stringstream ss;
+                if (to_gfa) {
+                    subgraph.to_gfa(ss, false);
+                } else {
+                    subgraph.serialize(ss);
                 }
-
+                const std::string buffer = ss.str();
+#pragma omp critical (archive)
+                {
+                    archive.write(buffer.data(), buffer.size());
+                    archive_index.emplace_back(component_index, archive_offset, buffer.size());
+                    archive_offset += buffer.size();
+                }
+            } else {
                 const string filename = output_dir_plus_prefix + "." + to_string(component_index) + (to_gfa ? ".gfa" : ".og");
 
                 // Save the component
@@ -251,14 +315,6 @@ namespace odgi {
                     subgraph.serialize(f);
                 }
                 f.close();
-
-                /*if (debug) {
-#pragma omp critical (cout)
-                        std::cerr << "Written component num. " << component_index
-                                  << " - num. of nodes " << subgraph.get_node_count()
-                                  << " - num. of paths: " << subgraph.get_path_count()
-                                  << std::endl;
-                }*/
             }
 
             if (progress) {
@@ -266,6 +322,21 @@ namespace odgi {
             }
         }
 
+        if (to_archive) {
+            archive.close();
+            std::sort(archive_index.begin(), archive_index.end());
+            std::ofstream index(archive_filename + ".idx");
+            if (index.fail()) {
+                std::cerr << "[odgi::explode] error: cannot write the archive index to " << archive_filename << ".idx." << std::endl;
+                return 1;
+            }
+            index << "#component\toffset\tlength" << std::endl;
+            for (auto& entry : archive_index) {
+                index << std::get<0>(entry) << "\t" << std::get<1>(entry) << "\t" << std::get<2>(entry) << "\n";
+            }
+            index.close();
+        }
+
         if (progress) {
             component_progress->finish();
         }
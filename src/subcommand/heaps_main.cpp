@@ -34,6 +34,10 @@ int main_heaps(int argc, char **argv) {
                                              {'n', "n-permutations"});
     args::ValueFlag<uint64_t> _min_node_depth(heaps_opts, "N", "Exclude nodes with less than this path depth (default: 0).",
                                          {'d', "min-node-depth"});
+    args::Flag _bit_parallel(heaps_opts, "bool", "Precompute a group x node presence bitmatrix of the considered nodes and compute each permutation "
+                                                 "by OR-ing the groups' node bits, summing the lengths of the newly covered nodes. "
+                                                 "Much faster for many permutations, at the cost of (groups x nodes) bits of memory.",
+                             {'B', "bit-parallel"});
     args::Group threading_opts(parser, "[ Threading ]");
     args::ValueFlag<uint64_t> nthreads(threading_opts, "N", "Number of threads to use for parallel operations.",
                                        {'t', "threads"});
@@ -181,7 +185,8 @@ int main_heaps(int argc, char **argv) {
         }
     };
 
-    algorithms::for_each_heap_permutation(graph, path_groups, intervals, n_permutations, min_node_depth, handle_output);
+    algorithms::for_each_heap_permutation(graph, path_groups, intervals, n_permutations, min_node_depth, handle_output,
+                                          args::get(_bit_parallel));
 
     return 0;
 }
@@ -4,7 +4,6 @@
 #include <omp.h>
 #include "algorithms/inject.hpp"
 #include "utils.hpp"
-#include "split.hpp"
 
 namespace odgi {
 
@@ -78,52 +77,32 @@ int main_inject(int argc, char **argv) {
         }
     }
 
-    ska::flat_hash_map<path_handle_t,
-                       std::vector<std::pair<interval_t, std::string>>> path_intervals;
+    std::vector<algorithms::bed_sequence_t> sequences;
     std::vector<std::string> ordered_intervals;
     if (_bed_targets) {
         std::ifstream bed(args::get(_bed_targets).c_str());
-        std::string line;
-        while (std::getline(bed, line)) {
-            if (!line.empty()) {
-                auto vals = split(line, '\t');
-                if (vals.size() < 3) {
-                    std::cerr << "[odgi::inject]"
-                              << "BED line does not have enough fields to define an interval"
-                              << std::endl << line << std::endl;
-                    return 1;
-                }
-                auto& path_name = vals[0];
-                uint64_t start = std::stoul(vals[1]);
-                uint64_t end = std::stoul(vals[2]);
-                const std::string& name = vals[3];
-                if (!graph.has_path(path_name)) {
-                    //std::cerr << "[odgi::inject] warning: no path '" << path_name << "' in graph" << std::endl;
-                } else {
-                    auto path = graph.get_path_handle(path_name);
-                    path_intervals[path].push_back(std::make_pair(interval_t(start, end), name));
-                    ordered_intervals.push_back(name);
-                }
-            }
-        }
-        // ensure sorted input
-        std::vector<std::vector<std::pair<interval_t, std::string>>*> v;
-        for (auto& i : path_intervals) {
-            v.push_back(&i.second);
-        }
-#pragma omp parallel for
-        for (auto& ivals : v) {
-            std::sort(ivals->begin(), ivals->end());
-        }
+        // records on paths that are not in the graph are skipped
+        algorithms::read_sorted_bed(bed, 4, "inject",
+                                    [&](const std::string& path_name) { return graph.has_path(path_name); },
+                                    sequences, &ordered_intervals);
     } else {
         std::cerr << "[odgi::inject] BED targets are required for injection of ranges" << std::endl;
         return 1;
     }
+    std::vector<path_handle_t> paths;
+    std::vector<std::vector<algorithms::bed_interval_t>> path_intervals;
+    paths.reserve(sequences.size());
+    path_intervals.reserve(sequences.size());
+    for (auto& sequence : sequences) {
+        paths.push_back(graph.get_path_handle(sequence.name));
+        path_intervals.push_back(std::move(sequence.intervals));
+    }
+    std::vector<algorithms::bed_sequence_t>().swap(sequences);
 
     omp_set_num_threads(num_threads);
     graph.set_number_of_threads(num_threads);
 
-    algorithms::inject_ranges(graph, path_intervals, ordered_intervals, args::get(progress));
+    algorithms::inject_ranges(graph, paths, path_intervals, ordered_intervals, args::get(progress));
 
     const std::string outfile = args::get(og_out_file);
     if (outfile == "-") {
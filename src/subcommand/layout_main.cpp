@@ -6,8 +6,11 @@
 #include "algorithms/xp.hpp"
 #include "algorithms/sgd_layout.hpp"
 #include "algorithms/path_sgd_layout.hpp"
+#include "algorithms/multilevel_layout.hpp"
 #include "algorithms/draw.hpp"
 #include "algorithms/layout.hpp"
+#include "algorithms/layout_tiles.hpp"
+#include "algorithms/instrumentation.hpp"
 #include "hilbert.hpp"
 #include "utils.hpp"
 
@@ -32,6 +35,8 @@ int main_layout(int argc, char **argv) {
     args::Group files_io_opts(parser, "[ Files IO ]");
     args::ValueFlag<std::string> layout_out_file(files_io_opts, "FILE", "Write the layout coordinates to this FILE in .lay binary format.", {'o', "out"});
     args::ValueFlag<std::string> tsv_out_file(files_io_opts, "FILE", "Write the layout in TSV format to this FILE.", {'T', "tsv"});
+    args::ValueFlag<std::string> tiles_out_file(files_io_opts, "FILE", "Write a level-of-detail tile pyramid of the layout to this FILE, for viewers that read only the visible tiles.", {'L', "tiles"});
+    args::ValueFlag<uint64_t> tiles_capacity(files_io_opts, "N", "Keep at most N node segments in each tile above the finest level of the tile pyramid (default: 4096).", {'Z', "tile-capacity"});
     args::ValueFlag<std::string> xp_in_file(files_io_opts, "FILE", "Load the path index from this FILE so that it does not have to be created for the layout calculation.", {'X', "path-index"});
     args::ValueFlag<std::string> tmp_base(files_io_opts, "PATH", "directory for temporary files", {'C', "temp-dir"});
     /// Path-guided-2D-SGD parameters
@@ -81,6 +86,15 @@ int main_layout(int argc, char **argv) {
     args::ValueFlag<std::string> p_sgd_snapshot(pg_sgd_opts, "STRING",
                                                 "Set the prefix to which each snapshot layout of a path guided 2D SGD iteration should be written to (default: NONE).",
                                                 {'u', "path-sgd-snapshot"});
+    args::Group multilevel_opts(parser, "[ Multi-level Layout Options ]");
+    args::Flag multilevel(multilevel_opts, "multilevel",
+                          "Coarsen the graph by merging nodes that follow each other in the paths, lay out the coarsest graph first and carry the layout down"
+                          " level by level, refining it on each level, before the path guided 2D SGD. The path guided 2D SGD then starts at a lower learning"
+                          " rate and runs 10 iterations by default.",
+                          {'M', "multilevel"});
+    args::ValueFlag<uint64_t> multilevel_coarsest(multilevel_opts, "N", "Stop coarsening the graph once it has at most N nodes (default: 1000).", {'m', "multilevel-coarsest"});
+    args::ValueFlag<uint64_t> multilevel_iter_max(multilevel_opts, "N", "The number of SGD iterations N on each coarsened graph (default: 10).", {'e', "multilevel-iter-max"});
+    args::Flag multilevel_repulsion(multilevel_opts, "repulsion", "Push apart overlapping nodes of the coarsened graphs after each iteration, finding them on a grid.", {'R', "multilevel-repulsion"});
     args::Group threading_opts(parser, "[ Threading ]");
     args::ValueFlag<uint64_t> nthreads(threading_opts, "N",
                                        "Number of threads to use for parallel operations.",
@@ -112,9 +126,9 @@ int main_layout(int argc, char **argv) {
         return 1;
     }
 
-    if (!layout_out_file && !tsv_out_file) {
+    if (!layout_out_file && !tsv_out_file && !tiles_out_file) {
         std::cerr
-            << "[odgi::layout] error: Please specify an output file to where to store the layout via -o/--out=[FILE] or -T/--tsv=[FILE]."
+            << "[odgi::layout] error: Please specify an output file to where to store the layout via -o/--out=[FILE], -T/--tsv=[FILE] or -L/--tiles=[FILE]."
             << std::endl;
         return 1;
     }
@@ -190,7 +204,7 @@ int main_layout(int argc, char **argv) {
             << std::endl;
         return 1;
     }
-    uint64_t path_sgd_iter_max = p_sgd_iter_max ? args::get(p_sgd_iter_max) : 30;
+    uint64_t path_sgd_iter_max = p_sgd_iter_max ? args::get(p_sgd_iter_max) : (multilevel ? 10 : 30);
     uint64_t path_sgd_iter_max_learning_rate = p_sgd_iter_with_max_learning_rate ? args::get(
         p_sgd_iter_with_max_learning_rate) : 0;
     double path_sgd_zipf_theta = p_sgd_zipf_theta ? args::get(p_sgd_zipf_theta) : 0.99;
@@ -218,7 +232,9 @@ int main_layout(int argc, char **argv) {
         path_index.load(in);
         in.close();
     } else {
+        algorithms::instrumentation::Phase phase("path_index");
         path_index.from_handle_graph(graph, num_threads);
+        phase.add_items(graph.get_path_count());
     }
     // do we only want so sample from a subset of paths?
     if (p_sgd_in_file) {
@@ -324,6 +340,28 @@ int main_layout(int argc, char **argv) {
           //std::cerr << pos << ": " << graph_X[pos] << "," << graph_Y[pos] << " ------ " << graph_X[pos + 1] << "," << graph_Y[pos + 1] << std::endl;
       });
 
+    if (multilevel) {
+        algorithms::instrumentation::Phase phase("multilevel_layout");
+        phase.add_items(graph.get_node_count());
+        const double multilevel_eta_max = algorithms::multilevel_path_sgd_layout(
+            graph,
+            path_sgd_use_paths,
+            multilevel_coarsest ? args::get(multilevel_coarsest) : algorithms::multilevel_layout_default_coarsest,
+            multilevel_iter_max ? args::get(multilevel_iter_max) : 10,
+            eps,
+            args::get(multilevel_repulsion),
+            num_threads,
+            show_progress,
+            graph_X,
+            graph_Y);
+        // the coarse levels already placed the nodes, so only local distances are left to fix
+        if (multilevel_eta_max > 0 && !p_sgd_eta_max) {
+            path_sgd_max_eta = multilevel_eta_max;
+        }
+    }
+
+    algorithms::instrumentation::Phase layout_phase("layout");
+    layout_phase.add_items(path_sgd_iter_max * path_sgd_min_term_updates);
     //double max_x = 0;
     algorithms::path_linear_sgd_layout(
         graph,
@@ -347,6 +385,7 @@ int main_layout(int argc, char **argv) {
         graph_X,
         graph_Y
         );
+    layout_phase.end();
 
     // drop out of atomic stuff... maybe not the best way to do this
     // TODO: use directly the atomic vector?
@@ -362,7 +401,7 @@ int main_layout(int argc, char **argv) {
     }
 
     // refine order by weakly connected components
-    std::vector<std::vector<handlegraph::handle_t>> weak_components = algorithms::weakly_connected_component_vectors(&graph);
+    std::vector<std::vector<handlegraph::handle_t>> weak_components = algorithms::weakly_connected_component_vectors(&graph, num_threads);
 
     //uint64_t num_components_on_each_dimension = std::ceil(sqrt(weak_components.size()));
     //std::cerr << " num_components_on_each_dimension " << num_components_on_each_dimension << std::endl;
@@ -411,9 +450,24 @@ int main_layout(int argc, char **argv) {
         }
     }
 
+    if (tiles_out_file) {
+        auto& outfile = args::get(tiles_out_file);
+        if (outfile.size()) {
+            const uint64_t capacity = tiles_capacity ? args::get(tiles_capacity) : algorithms::layout::layout_tiles_default_capacity;
+            algorithms::instrumentation::Phase phase("write_tiles");
+            phase.add_items(graph.get_node_count());
+            if (!algorithms::layout::write_layout_tiles(outfile, graph, X_final, Y_final, capacity, num_threads)) {
+                std::cerr << "[odgi::layout] error: could not write the layout tiles to '" << outfile << "'." << std::endl;
+                return 1;
+            }
+        }
+    }
+
     if (layout_out_file) {
         auto& outfile = args::get(layout_out_file);
         if (outfile.size()) {
+            algorithms::instrumentation::Phase phase("write");
+            phase.add_items(graph.get_node_count());
             algorithms::layout::Layout lay(X_final, Y_final);
             if (outfile == "-") {
                 lay.serialize(std::cout);
@@ -3,6 +3,7 @@
 #include "args.hxx"
 #include "algorithms/matrix_writer.hpp"
 #include "utils.hpp"
+#include <fstream>
 
 namespace odgi {
 
@@ -24,6 +25,8 @@ int main_matrix(int argc, char** argv) {
     args::Group matrix_opts(parser, "[ Matrix Options ]");
     args::Flag weight_by_edge_depth(matrix_opts, "edge-depth-weight", "Weigh edges by their path depth.", {'e', "edge-depth-weight"});
     args::Flag weight_by_edge_delta(matrix_opts, "delta-weight", "Weigh edges by the inverse id delta.", {'d', "delta-weight"});
+    args::ValueFlag<std::string> binary_out_file(matrix_opts, "FILE", "Write the matrix to *FILE* in a binary compressed sparse row format"
+                                                 " (0-based rows and columns) instead of printing text triplets to stdout.", {'b', "binary"});
 	args::Group threading(parser, "[ Threading ]");
 	args::ValueFlag<uint64_t> nthreads(threading, "N", "Number of threads to use for parallel operations.", {'t', "threads"});
 	args::Group processing_info_opts(parser, "[ Processing Information ]");
@@ -67,7 +70,17 @@ int main_matrix(int argc, char** argv) {
         }
     }
 
-    algorithms::write_as_sparse_matrix(std::cout, graph, args::get(weight_by_edge_depth), args::get(weight_by_edge_delta));
+    if (binary_out_file) {
+        const auto matrix = algorithms::build_sparse_matrix(graph, args::get(weight_by_edge_depth), args::get(weight_by_edge_delta), num_threads);
+        std::ofstream out(args::get(binary_out_file), std::ios::binary);
+        if (!out) {
+            std::cerr << "[odgi::matrix] error: cannot write to " << args::get(binary_out_file) << "." << std::endl;
+            return 1;
+        }
+        algorithms::write_as_binary_sparse_matrix(out, matrix);
+    } else {
+        algorithms::write_as_sparse_matrix(std::cout, graph, args::get(weight_by_edge_depth), args::get(weight_by_edge_delta));
+    }
 
     return 0;
 }
@@ -3,8 +3,9 @@
 #include "position.hpp"
 #include "args.hxx"
 #include "subgraph/region.hpp"
+#include "algorithms/bed_intervals.hpp"
 #include <omp.h>
-#include <mutex>
+#include <unordered_set>
 #include "utils.hpp"
 
 namespace odgi {
@@ -125,95 +126,98 @@ namespace odgi {
             }
         }
 
-        auto get_graph_pos = [](const odgi::graph_t &graph,
-                                const path_pos_t &pos) {
-            auto path_end = graph.path_end(pos.path);
-            uint64_t walked = 0;
-            for (step_handle_t s = graph.path_begin(pos.path);
-                 s != path_end; s = graph.get_next_step(s)) {
-                handle_t h = graph.get_handle_of_step(s);
-                uint64_t node_length = graph.get_length(h);
-                if (walked + node_length > pos.offset) {
-                    return make_pos_t(graph.get_id(h), graph.get_is_reverse(h), pos.offset - walked);
+        if (!path_ranges.empty()) {
+            // group the ranges by path, so that each path is walked once for all of its ranges
+            ska::flat_hash_map<path_handle_t, uint64_t> path_group;
+            std::vector<path_handle_t> range_paths;
+            std::vector<std::vector<uint64_t>> path_range_ids;
+            for (uint64_t i = 0; i < path_ranges.size(); ++i) {
+                const path_handle_t path = path_ranges[i].begin.path;
+                auto f = path_group.find(path);
+                if (f == path_group.end()) {
+                    f = path_group.insert(std::make_pair(path, (uint64_t)range_paths.size())).first;
+                    range_paths.push_back(path);
+                    path_range_ids.emplace_back();
                 }
-                walked += node_length;
+                path_range_ids[f->second].push_back(i);
             }
 
-#pragma omp critical (cout)
-            std::cerr << "[odgi::overlap] warning: position " << graph.get_path_name(pos.path) << ":" << pos.offset
-                      << " outside of path" << std::endl;
-            return make_pos_t(0, false, 0);
-        };
-
-        auto get_offset_in_path = [](const odgi::graph_t &graph,
-                                     const path_handle_t &path, const step_handle_t &target) {
-            auto path_end = graph.path_end(path);
-            uint64_t walked = 0;
-            step_handle_t s = graph.path_begin(path);
-            for (; s != target; s = graph.get_next_step(s)) {
-                handle_t h = graph.get_handle_of_step(s);
-                walked += graph.get_length(h);
+            // find the first and the last step crossed by each range
+            // nodes ending at the start of a range are counted as crossed
+            std::vector<std::pair<step_handle_t, step_handle_t>> range_steps(path_ranges.size());
+            std::vector<uint8_t> range_found(path_ranges.size(), false);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+            for (uint64_t g = 0; g < range_paths.size(); ++g) {
+                auto& ids = path_range_ids[g];
+                std::sort(ids.begin(), ids.end(), [&](const uint64_t& a, const uint64_t& b) {
+                    return path_ranges[a].begin.offset < path_ranges[b].begin.offset
+                        || (path_ranges[a].begin.offset == path_ranges[b].begin.offset && a < b);
+                });
+                std::vector<algorithms::bed_interval_t> intervals;
+                intervals.reserve(ids.size());
+                for (auto& i : ids) {
+                    const uint64_t start = path_ranges[i].begin.offset;
+                    intervals.push_back({start > 0 ? start - 1 : 0, path_ranges[i].end.offset, ""});
+                }
+                algorithms::sweep_path_intervals(
+                    graph, range_paths[g], intervals,
+                    [&](const uint64_t& j, const step_handle_t& step, const uint64_t& offset) {
+                        range_steps[ids[j]].first = step;
+                    },
+                    [&](const uint64_t& j, const step_handle_t& step, const uint64_t& offset, const bool& clipped) {
+                        range_steps[ids[j]].second = step;
+                        range_found[ids[j]] = true;
+                    });
             }
-            assert(s != path_end);
-            return walked;
-        };
-
-        if (!path_ranges.empty()) {
-            std::cout << "#path\tstart\tend\tpath.touched" << std::endl;
-
-//#pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
-            for (auto &path_range : path_ranges) {
-                // Collect handles crossed by the path in the specified range
-                uint64_t start = path_range.begin.offset;
-                uint64_t end = path_range.end.offset;
-                path_handle_t path_handle = path_range.begin.path;
 
-                std::unordered_set<handle_t> handles;
-
-                uint64_t walked = 0;
-                auto path_end = graph.path_end(path_handle);
-                for (step_handle_t cur_step = graph.path_begin(path_handle);
-                     cur_step != path_end && walked < end; cur_step = graph.get_next_step(cur_step)) {
-                    handle_t cur_handle = graph.get_handle_of_step(cur_step);
-                    uint64_t cur_length = graph.get_length(cur_handle);
-                    walked += cur_length;
-                    if (walked >= start) {
-                        handles.insert(cur_handle);
-                    }
+            std::vector<bool> consider;
+            for (auto& p : paths_to_consider) {
+                if (as_integer(p) >= consider.size()) {
+                    consider.resize(as_integer(p) + 1, false);
                 }
+                consider[as_integer(p)] = true;
+            }
 
-                // Collect paths that cross the collected handles
-                std::vector<path_handle_t> touched_path_handles;
-
-                std::mutex touched_path_handles_mutex;
+            // collect the paths that cross the handles of each range, through the steps on the handles
+            std::vector<std::vector<path_handle_t>> touched(path_ranges.size());
 #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
-                for (path_handle_t p_h : paths_to_consider) {
-                    if (p_h != path_handle) {
-                        bool stop = false;
-                        graph.for_each_step_in_path(p_h, [&](const step_handle_t &step) {
-                            if (!stop && handles.count(graph.get_handle_of_step(step)) > 0) {
-                                {
-                                    std::lock_guard<std::mutex> guard(touched_path_handles_mutex);
-                                    touched_path_handles.push_back(p_h);
-                                }
-
-                                stop = true;
-                            }
-                        });
-                    }
+            for (uint64_t i = 0; i < path_ranges.size(); ++i) {
+                if (!range_found[i]) {
+                    continue;
                 }
+                const path_handle_t path_handle = path_ranges[i].begin.path;
+                std::unordered_set<handle_t> handles;
+                const step_handle_t end = graph.get_next_step(range_steps[i].second);
+                for (step_handle_t s = range_steps[i].first; s != end; s = graph.get_next_step(s)) {
+                    handles.insert(graph.get_handle_of_step(s));
+                }
+                std::unordered_set<path_handle_t> touched_path_handles;
+                for (auto& h : handles) {
+                    graph.for_each_step_on_handle(h, [&](const step_handle_t& step) {
+                        const path_handle_t p_h = graph.get_path_handle_of_step(step);
+                        if (p_h != path_handle
+                            && as_integer(p_h) < consider.size() && consider[as_integer(p_h)]
+                            && graph.get_handle_of_step(step) == h) {
+                            touched_path_handles.insert(p_h);
+                        }
+                    });
+                }
+                touched[i].assign(touched_path_handles.begin(), touched_path_handles.end());
+                std::sort(touched[i].begin(), touched[i].end(),
+                          [](const path_handle_t& a, const path_handle_t& b) {
+                              return as_integer(a) < as_integer(b);
+                          });
+            }
 
-                std::sort(touched_path_handles.begin(), touched_path_handles.end(),
-                        [](const path_handle_t& a, const path_handle_t& b) {
-                            return as_integer(a) < as_integer(b);
-                        });
-
-//#pragma omp critical (cout)
-                for (auto touched_path_handle : touched_path_handles) {
-                    std::cout << (graph.get_path_name(path_handle)) << "\t" << start << "\t" << end << "\t"
-                              << graph.get_path_name(touched_path_handle) << std::endl;
+            std::cout << "#path\tstart\tend\tpath.touched" << std::endl;
+            for (uint64_t i = 0; i < path_ranges.size(); ++i) {
+                const std::string path_name = graph.get_path_name(path_ranges[i].begin.path);
+                for (auto touched_path_handle : touched[i]) {
+                    std::cout << path_name << "\t" << path_ranges[i].begin.offset << "\t" << path_ranges[i].end.offset << "\t"
+                              << graph.get_path_name(touched_path_handle) << "\n";
                 }
             }
+            std::cout.flush();
         }
 
         return 0;
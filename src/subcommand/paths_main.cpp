@@ -4,8 +4,12 @@
 #include "split.hpp"
 #include "position.hpp"
 #include <omp.h>
+#include <unordered_map>
 #include "utils.hpp"
 #include "algorithms/path_keep.hpp"
+#include "algorithms/subgraph/region.hpp"
+#include "algorithms/bed_intervals.hpp"
+#include "dna.hpp"
 
 namespace odgi {
 
@@ -35,6 +39,9 @@ int main_paths(int argc, char** argv) {
 	args::Flag list_path_start_end(path_investigation_opts, "list-path-start-end", "If -L,--list-paths was specified, this additionally prints the start and end positions of each path in additional, tab-delimited coloumns."
 						   , {'l', "list-path-start-end"});
     args::Flag write_fasta(path_investigation_opts, "fasta", "Print paths in FASTA format to stdout. One line for the FASTA header, another line for the whole sequence.", {'f', "fasta"});
+    args::ValueFlag<std::string> fasta_bed_file(path_investigation_opts, "FILE", "For **-f, --fasta**: print only the sequences of the path ranges in this BED *FILE*,"
+                                                              " in the order of the file. Ranges on the '-' strand are reverse complemented."
+                                                              " The FASTA header of each range is *path:start-end*.", {'b', "bed-input"});
     args::Flag haplo_matrix(path_investigation_opts, "haplo", "Print to stdout the paths in a path coverage haplotype matrix"
                                                               " based on the graph’s sort order. The output is tab-delimited:"
                                                               " *path.name*, *path.length*, *path.step.count*, *node.1*,"
@@ -82,6 +89,11 @@ int main_paths(int argc, char** argv) {
         return 1;
     }
 
+	if (fasta_bed_file && !write_fasta) {
+		std::cerr << "[odgi::paths] error: please specify also -f,--fasta with the -b,--bed-input option!" << std::endl;
+		return 1;
+	}
+
 	if (list_path_start_end && !list_names) {
 		std::cerr << "[odgi::paths] error: please specify also -L,--list-path with the -l,--list-path-start-end option!" << std::endl;
 		return 1;
@@ -128,15 +140,173 @@ int main_paths(int argc, char** argv) {
     }
 
     if (args::get(write_fasta)) {
-        graph.for_each_path_handle(
-            [&](const path_handle_t& p) {
-                std::cout << ">" << graph.get_path_name(p) << std::endl;
-                graph.for_each_step_in_path(
-                    p, [&](const step_handle_t& s) {
-                           std::cout << graph.get_sequence(graph.get_handle_of_step(s));
-                       });
-                std::cout << std::endl;
+        // one FASTA record per path, or per BED range when given
+        struct fasta_record_t {
+            path_handle_t path;
+            uint64_t start;
+            uint64_t end;
+            bool is_rev;
+            std::string name;
+        };
+        // a run of consecutive steps, the unit of parallel sequence reconstruction
+        struct fasta_chunk_t {
+            uint64_t record;
+            step_handle_t first_step;
+            uint64_t offset; // position of the first step in the path
+            uint64_t n_steps;
+        };
+        std::vector<fasta_record_t> records;
+        if (fasta_bed_file) {
+            std::vector<path_range_t> path_ranges;
+            std::ifstream bed_in(args::get(fasta_bed_file));
+            std::string buffer;
+            while (std::getline(bed_in, buffer)) {
+                add_bed_range(path_ranges, graph, buffer);
+            }
+            for (auto& range : path_ranges) {
+                records.push_back({range.begin.path, range.begin.offset, range.end.offset, range.is_rev,
+                                   graph.get_path_name(range.begin.path) + ":" + std::to_string(range.begin.offset)
+                                   + "-" + std::to_string(range.end.offset)});
+            }
+        } else {
+            graph.for_each_path_handle([&](const path_handle_t& p) {
+                records.push_back({p, 0, std::numeric_limits<uint64_t>::max(), false, graph.get_path_name(p)});
             });
+        }
+
+        // find the first step of each record: the first step of its path, or for BED ranges,
+        // the step where the range starts, found by sweeping each path once over its ranges
+        std::vector<step_handle_t> first_steps(records.size());
+        std::vector<uint64_t> first_offsets(records.size(), 0); // position of the first step in the path
+        std::vector<uint8_t> has_first_step(records.size(), 0);
+        if (fasta_bed_file) {
+            std::unordered_map<path_handle_t, uint64_t> path_group;
+            std::vector<path_handle_t> group_paths;
+            std::vector<std::vector<uint64_t>> group_records;
+            for (uint64_t i = 0; i < records.size(); ++i) {
+                auto f = path_group.find(records[i].path);
+                if (f == path_group.end()) {
+                    f = path_group.emplace(records[i].path, group_paths.size()).first;
+                    group_paths.push_back(records[i].path);
+                    group_records.emplace_back();
+                }
+                group_records[f->second].push_back(i);
+            }
+#pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+            for (uint64_t g = 0; g < group_paths.size(); ++g) {
+                auto& group = group_records[g];
+                std::sort(group.begin(), group.end(), [&](const uint64_t& a, const uint64_t& b) {
+                    return std::tie(records[a].start, records[a].end, a) < std::tie(records[b].start, records[b].end, b);
+                });
+                std::vector<algorithms::bed_interval_t> intervals(group.size());
+                for (uint64_t j = 0; j < group.size(); ++j) {
+                    intervals[j].start = records[group[j]].start;
+                    intervals[j].end = records[group[j]].end;
+                }
+                algorithms::sweep_path_intervals(
+                    graph, group_paths[g], intervals,
+                    [&](const uint64_t& j, const step_handle_t& step, const uint64_t& offset) {
+                        const uint64_t i = group[j];
+                        first_steps[i] = step;
+                        first_offsets[i] = records[i].start - offset;
+                        has_first_step[i] = 1;
+                    },
+                    [](const uint64_t& j, const step_handle_t& step, const uint64_t& offset, const bool& clipped) {});
+            }
+        } else {
+            for (uint64_t i = 0; i < records.size(); ++i) {
+                if (!graph.is_empty(records[i].path)) {
+                    first_steps[i] = graph.path_begin(records[i].path);
+                    has_first_step[i] = 1;
+                }
+            }
+        }
+
+        // walk the steps overlapping each record, cutting long paths into chunks
+        const uint64_t chunk_steps = 1 << 16;
+        std::vector<std::vector<fasta_chunk_t>> record_chunks(records.size());
+#pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+        for (uint64_t i = 0; i < records.size(); ++i) {
+            auto& record = records[i];
+            auto& chunks = record_chunks[i];
+            uint64_t pos = first_offsets[i];
+            if (has_first_step[i]) {
+                step_handle_t step = first_steps[i];
+                while (pos < record.end) {
+                    const uint64_t next_pos = pos + graph.get_length(graph.get_handle_of_step(step));
+                    if (next_pos > record.start) {
+                        if (chunks.empty() || chunks.back().n_steps == chunk_steps) {
+                            chunks.push_back({i, step, pos, 0});
+                        }
+                        ++chunks.back().n_steps;
+                    }
+                    pos = next_pos;
+                    if (!graph.has_next_step(step)) {
+                        break;
+                    }
+                    step = graph.get_next_step(step);
+                }
+            }
+            record.end = std::min(record.end, pos);
+            record.start = std::min(record.start, record.end);
+        }
+
+        // reconstruct the records in batches bounded in size, writing each batch in order
+        const uint64_t batch_bp = 1ULL << 30;
+        std::vector<std::string> sequences(records.size());
+        std::vector<fasta_chunk_t> batch_chunks;
+        uint64_t batch_begin = 0;
+        while (batch_begin < records.size()) {
+            uint64_t batch_end = batch_begin;
+            uint64_t bp = 0;
+            batch_chunks.clear();
+            do {
+                const auto& record = records[batch_end];
+                bp += record.end - record.start;
+                sequences[batch_end].resize(record.end - record.start);
+                batch_chunks.insert(batch_chunks.end(), record_chunks[batch_end].begin(), record_chunks[batch_end].end());
+                ++batch_end;
+            } while (batch_end < records.size() && bp + records[batch_end].end - records[batch_end].start <= batch_bp);
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+            for (uint64_t j = 0; j < batch_chunks.size(); ++j) {
+                const auto& chunk = batch_chunks[j];
+                const auto& record = records[chunk.record];
+                auto& sequence = sequences[chunk.record];
+                step_handle_t step = chunk.first_step;
+                uint64_t pos = chunk.offset;
+                for (uint64_t k = 0; k < chunk.n_steps; ++k) {
+                    const std::string seq = graph.get_sequence(graph.get_handle_of_step(step));
+                    // clip the node to the record
+                    const uint64_t begin = std::max(pos, record.start);
+                    const uint64_t end = std::min(pos + seq.size(), record.end);
+                    if (begin < end) {
+                        std::copy(seq.begin() + (begin - pos), seq.begin() + (end - pos),
+                                  sequence.begin() + (begin - record.start));
+                    }
+                    pos += seq.size();
+                    if (k + 1 < chunk.n_steps) {
+                        step = graph.get_next_step(step);
+                    }
+                }
+            }
+#pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+            for (uint64_t i = batch_begin; i < batch_end; ++i) {
+                if (records[i].is_rev) {
+                    reverse_complement_in_place(sequences[i]);
+                }
+            }
+
+            for (uint64_t i = batch_begin; i < batch_end; ++i) {
+                std::cout << ">" << records[i].name << "\n";
+                std::cout.write(sequences[i].data(), sequences[i].size());
+                std::cout << "\n";
+                std::string().swap(sequences[i]);
+                std::vector<fasta_chunk_t>().swap(record_chunks[i]);
+            }
+            batch_begin = batch_end;
+        }
+        std::cout.flush();
     }
 
     const uint16_t delim_pos = path_delim_pos ? args::get(path_delim_pos) - 1 : 0;
@@ -193,9 +193,6 @@ int main_pav(int argc, char **argv) {
         return 1;
     }
 
-    std::vector<unordered_set<handle_t>> path_range_node_handles;
-    path_range_node_handles.resize(path_ranges.size());
-
     // Check the min/max coordinates for each target path
     ska::flat_hash_map<path_handle_t, std::pair<uint64_t, uint64_t>> path_name_2_min_max;
     for (uint64_t i = 0; i < path_ranges.size(); ++i) {
@@ -274,8 +271,56 @@ int main_pav(int argc, char **argv) {
     }
     std::cout << std::endl;
 
+    // Rank of the group (or path) each path belongs to, -1 if it is not in any group
+    const uint64_t n_groups = group_paths ? group_2_index.size() : graph.get_path_count();
+    std::vector<int64_t> path_group_rank;
+    graph.for_each_path_handle([&](const path_handle_t& path_handle) {
+        if (as_integer(path_handle) >= path_group_rank.size()) {
+            path_group_rank.resize(as_integer(path_handle) + 1, -1);
+        }
+        if (!group_paths) {
+            path_group_rank[as_integer(path_handle)] = as_integer(path_handle) - 1;
+        } else {
+            auto f = path_2_group.find(path_handle);
+            if (f != path_2_group.end()) {
+                path_group_rank[as_integer(path_handle)] = group_2_index[f->second];
+            }
+        }
+    });
+
+    // Collect the nodes under the path ranges, they are the rows of the membership bitmatrix
+    std::vector<nid_t> node_ids;
+    for (auto& tree : trees) {
+        for (size_t j = 0; j < tree.size(); ++j) {
+            node_ids.push_back(tree.data(j));
+        }
+    }
+    std::sort(node_ids.begin(), node_ids.end());
+    node_ids.erase(std::unique(node_ids.begin(), node_ids.end()), node_ids.end());
+    auto get_node_row = [&node_ids](const nid_t& node_id) {
+        return std::lower_bound(node_ids.begin(), node_ids.end(), node_id) - node_ids.begin();
+    };
+
+    // For each node, one bit per group telling whether the group crosses the node
+    const uint64_t words_per_row = (n_groups + 63) / 64;
+    std::vector<uint64_t> node_group_bits(node_ids.size() * words_per_row, 0);
+    std::vector<uint64_t> node_lengths(node_ids.size());
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(num_threads)
+    for (uint64_t row = 0; row < node_ids.size(); ++row) {
+        const handle_t handle = graph.get_handle(node_ids[row]);
+        node_lengths[row] = graph.get_length(handle);
+        uint64_t* bits = &node_group_bits[row * words_per_row];
+        graph.for_each_step_on_handle(handle, [&](const step_handle_t &source_step) {
+            const int64_t group_rank = path_group_rank[as_integer(graph.get_path_handle_of_step(source_step))];
+            // Check if the paths are grouped and there are paths that do not belong to any group
+            if (group_rank >= 0) {
+                bits[group_rank >> 6] |= 1ULL << (group_rank & 63);
+            }
+        });
+    }
+
     auto print_pav_table_row = [](
-            const basic_ostream<char>& stream,
+            std::ostream& stream,
             graph_t& graph,
             const uint64_t len_unique_nodes_in_range,
             const std::vector<uint64_t>& len_unique_nodes_in_range_for_each_group,
@@ -287,106 +332,98 @@ int main_pav(int argc, char **argv) {
         // Check if there were nodes in the range
         const double pav_ratio = len_unique_nodes_in_range == 0 ?
                                  0 : (double) len_unique_nodes_in_range_for_each_group[group_rank] / (double) len_unique_nodes_in_range;
-        std::cout << std::setprecision(5)
-                  << graph.get_path_name(path_range.begin.path) << "\t"
-                  << path_range.begin.offset << "\t"
-                  << path_range.end.offset << "\t"
-                  << path_range.name << "\t"
-                  << group_name << "\t"
-                  << (emit_binary_values ? pav_ratio >= binary_threshold : pav_ratio) << "\n";
+        stream << std::setprecision(5)
+               << graph.get_path_name(path_range.begin.path) << "\t"
+               << path_range.begin.offset << "\t"
+               << path_range.end.offset << "\t"
+               << path_range.name << "\t"
+               << group_name << "\t"
+               << (emit_binary_values ? pav_ratio >= binary_threshold : pav_ratio) << "\n";
     };
 
-#pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
-    for (uint64_t i = 0; i < path_ranges.size(); ++i) {
-        auto &path_range = path_ranges[i];
-        const uint64_t begin = path_range.begin.offset;
-        const uint64_t end = path_range.end.offset;
-
-        const uint64_t index = path_handle_2_index[path_range.begin.path];
-        auto& tree = trees[index];
+    std::vector<std::string> group_names;
+    group_names.reserve(n_groups);
+    if (group_paths) {
+        for (auto& x : group_2_index) {
+            group_names.push_back(x.first);
+        }
+    } else {
+        graph.for_each_path_handle([&](const path_handle_t path_handle) {
+            group_names.push_back(graph.get_path_name(path_handle));
+        });
+    }
 
-        std::vector<size_t> node_ids_info;
-        tree.overlap(begin, end, node_ids_info); // retrieve overlaps
-
-        uint64_t len_unique_nodes_in_range = 0;
-        std::vector<uint64_t> len_unique_nodes_in_range_for_each_group(
-                group_paths ? group_2_index.size() : graph.get_path_count(),
-                0);
-
-        // For each node in the range
-        for (const auto& node_id_info : node_ids_info) {
-            const auto& node_id = tree.data(node_id_info);
-            const auto& handle = graph.get_handle(node_id);
-
-            // Get paths that cross the node
-            unordered_set<uint64_t> group_ranks_on_node_handle;
-            graph.for_each_step_on_handle(handle, [&](const step_handle_t &source_step) {
-                const auto& path_handle = graph.get_path_handle_of_step(source_step);
-                // Check if the paths are grouped and there are paths that do not belong to any group
-                if (!group_paths || path_2_group.find(path_handle) != path_2_group.end()) {
-                    const uint64_t group_rank = group_paths ?
-                            group_2_index[path_2_group[path_handle]] :
-                            as_integer(path_handle) - 1;
-                    group_ranks_on_node_handle.insert(group_rank);
+    // Compute the ranges in batches, buffering each row, and write each batch in input order
+    const uint64_t batch_size = std::max((uint64_t)1024, 64 * num_threads);
+    std::vector<std::string> batch_rows(batch_size);
+    for (uint64_t batch_begin = 0; batch_begin < path_ranges.size(); batch_begin += batch_size) {
+        const uint64_t batch_end = std::min(batch_begin + batch_size, (uint64_t)path_ranges.size());
+#pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+        for (uint64_t i = batch_begin; i < batch_end; ++i) {
+            auto &path_range = path_ranges[i];
+            const uint64_t begin = path_range.begin.offset;
+            const uint64_t end = path_range.end.offset;
+
+            const uint64_t index = path_handle_2_index[path_range.begin.path];
+            auto& tree = trees[index];
+
+            std::vector<size_t> node_ids_info;
+            tree.overlap(begin, end, node_ids_info); // retrieve overlaps
+
+            uint64_t len_unique_nodes_in_range = 0;
+            std::vector<uint64_t> len_unique_nodes_in_range_for_each_group(n_groups, 0);
+
+            // For each node in the range, add its length to each group whose bit is set
+            for (const auto& node_id_info : node_ids_info) {
+                const uint64_t row = get_node_row(tree.data(node_id_info));
+                const uint64_t len_handle = node_lengths[row];
+                const uint64_t* bits = &node_group_bits[row * words_per_row];
+                for (uint64_t w = 0; w < words_per_row; ++w) {
+                    uint64_t word = bits[w];
+                    while (word) {
+                        len_unique_nodes_in_range_for_each_group[(w << 6) + __builtin_ctzll(word)] += len_handle;
+                        word &= word - 1;
+                    }
                 }
-            });
 
-            const uint64_t len_handle = graph.get_length(handle);
-            for (const auto& group_rank: group_ranks_on_node_handle) {
-                len_unique_nodes_in_range_for_each_group[group_rank] += len_handle;
+                len_unique_nodes_in_range += len_handle;
             }
 
-            len_unique_nodes_in_range += len_handle;
-        }
-
-#pragma omp critical (cout)
-        {
+            std::stringstream row_stream;
             if (emit_matrix_else_table) {
-                std::cout << std::setprecision(5)
-                          << graph.get_path_name(path_range.begin.path) << "\t"
-                          << path_range.begin.offset << "\t"
-                          << path_range.end.offset << "\t"
-                          << path_range.name;
+                row_stream << std::setprecision(5)
+                           << graph.get_path_name(path_range.begin.path) << "\t"
+                           << path_range.begin.offset << "\t"
+                           << path_range.end.offset << "\t"
+                           << path_range.name;
                 for (auto& x: len_unique_nodes_in_range_for_each_group) {
                     // Check if there were nodes in the range
                     const double pav_ratio = len_unique_nodes_in_range == 0 ?
                                              0 : (double) x / (double) len_unique_nodes_in_range;
-                    std::cout << "\t" << (emit_binary_values ? pav_ratio >= binary_threshold : pav_ratio);
+                    row_stream << "\t" << (emit_binary_values ? pav_ratio >= binary_threshold : pav_ratio);
                 }
-                std::cout << std::endl;
+                row_stream << "\n";
             } else {
-                if (group_paths) {
-                    for (auto& x : group_2_index) {
-                        const uint64_t group_rank = x.second;
-                        print_pav_table_row(
-                                std::cout,
-                                graph,
-                                len_unique_nodes_in_range,
-                                len_unique_nodes_in_range_for_each_group,
-                                x.first,
-                                group_rank,
-                                path_range,
-                                emit_binary_values,
-                                binary_threshold);
-                    }
-                } else {
-                    graph.for_each_path_handle([&](const path_handle_t path_handle) {
-                        const uint64_t group_rank = as_integer(path_handle) - 1;
-                        print_pav_table_row(
-                                std::cout,
-                                graph,
-                                len_unique_nodes_in_range,
-                                len_unique_nodes_in_range_for_each_group,
-                                graph.get_path_name(path_handle),
-                                group_rank,
-                                path_range,
-                                emit_binary_values,
-                                binary_threshold);
-                    });
+                for (uint64_t group_rank = 0; group_rank < n_groups; ++group_rank) {
+                    print_pav_table_row(
+                            row_stream,
+                            graph,
+                            len_unique_nodes_in_range,
+                            len_unique_nodes_in_range_for_each_group,
+                            group_names[group_rank],
+                            group_rank,
+                            path_range,
+                            emit_binary_values,
+                            binary_threshold);
                 }
             }
+            batch_rows[i - batch_begin] = row_stream.str();
+        }
+        for (uint64_t i = batch_begin; i < batch_end; ++i) {
+            std::cout << batch_rows[i - batch_begin];
         }
     }
+    std::cout.flush();
 
     return 0;
 }
@@ -4,20 +4,12 @@
 #include "split.hpp"
 #include <omp.h>
 #include "utils.hpp"
+#include "algorithms/path_intersection.hpp"
 
 namespace odgi {
 
 using namespace odgi::subcommand;
 
-// Functions used for the distance matrix generation
-inline uint64_t encode_pair(uint32_t v, uint32_t h) {
-    return ((uint64_t)v << 32) | (uint64_t)h;
-}
-inline void decode_pair(uint64_t pair, uint32_t *v, uint32_t *h) {
-    *v = pair >> 32;
-    *h = pair & 0x00000000FFFFFFFF;
-}
-
 int main_similarity(int argc, char** argv) {
 
     // trick argumentparser to do the right thing with the subcommand
@@ -146,36 +138,25 @@ args::Group threading_opts(parser, "[ Threading ]");
             (std::function<std::string(const uint32_t&)>)
             [&](const uint32_t& id) { return graph.get_path_name(as_path_handle(id)); });
 
-    auto get_path_id
-        = (using_delim ?
-            (std::function<uint32_t(const path_handle_t&)>)
-            [&](const path_handle_t& p) {
-                return path_handle_group_ids[p];
-            }
-            :
-            (std::function<uint32_t(const path_handle_t&)>)
-            [&](const path_handle_t& p) {
-                return (uint32_t)as_integer(p);
-            });
-
-    std::vector<uint64_t> bp_count;
-    if (using_delim) {
-        bp_count.resize(path_groups.size());
-    } else {
-        bp_count.resize(graph.get_path_count());
-    }
-
     uint32_t path_max = 0;
     graph.for_each_path_handle(
         [&](const path_handle_t& p) {
             path_max = std::max(path_max, (uint32_t)as_integer(p));
         });
 
-    // Initialize first to avoid possible bugs later
-    for (uint32_t i = 0; i < path_max; ++i) {
-        path_handle_t p = as_path_handle(i + 1);
-        bp_count[get_path_id(p)] = 0;
-    }
+    // a flat lookup, as the id of a path is queried for every step
+    std::vector<uint32_t> path_ids(path_max + 1, 0);
+    graph.for_each_path_handle(
+        [&](const path_handle_t& p) {
+            path_ids[as_integer(p)] = using_delim ? path_handle_group_ids[p] : (uint32_t)as_integer(p);
+        });
+    auto get_path_id = [&](const path_handle_t& p) {
+        return path_ids[as_integer(p)];
+    };
+
+    // path ids are path handles, which start at 1
+    const uint32_t n_ids = using_delim ? path_groups.size() : path_max + 1;
+    std::vector<uint64_t> bp_count(n_ids, 0);
 
 #pragma omp parallel for
     for (uint32_t i = 0; i < path_max; ++i) {
@@ -190,41 +171,6 @@ args::Group threading_opts(parser, "[ Threading ]");
         bp_count[get_path_id(p)] += path_length;
     }
 
-    const bool show_progress = args::get(progress);
-    std::unique_ptr<algorithms::progress_meter::ProgressMeter> progress_meter;
-    if (show_progress) {
-        progress_meter = std::make_unique<algorithms::progress_meter::ProgressMeter>(
-                graph.get_node_count(), "[odgi::similarity] collecting path intersection lengths");
-    }
-
-    // ska::flat_hash_map<std::pair<uint64_t, uint64_t>, uint64_t> leads to huge memory usage with deep graphs
-    ska::flat_hash_map<uint64_t, uint64_t> path_intersection_length;
-    graph.for_each_handle(
-        [&](const handle_t& h) {
-            ska::flat_hash_map<uint32_t, uint64_t> local_path_lengths;
-            size_t l = graph.get_length(h);
-            graph.for_each_step_on_handle(
-                h,
-                [&](const step_handle_t& s) {
-                    local_path_lengths[get_path_id(graph.get_path_handle_of_step(s))] += l;
-                });
-
-#pragma omp critical (path_intersection_length)
-            for (auto& p : local_path_lengths) {
-                for (auto& q : local_path_lengths) {
-                    path_intersection_length[encode_pair(p.first, q.first)] += std::min(p.second, q.second);
-                }
-            }
-
-            if (show_progress) {
-                progress_meter->increment(1);
-            }
-        }, true);
-
-    if (show_progress) {
-        progress_meter->finish();
-    }
-
     /*if (using_delim) {
         std::cout << "group.a" << "\t"
                     << "group.b" << "\t"
@@ -258,11 +204,9 @@ args::Group threading_opts(parser, "[ Threading ]");
     }
 
     std::cout << std::endl;
-    for (auto& p : path_intersection_length) {
-        uint32_t id_a, id_b;
-        decode_pair(p.first, &id_a, &id_b);
-
-        auto& intersection = p.second;
+    algorithms::for_each_path_intersection(
+        graph, n_ids, get_path_id, num_threads, args::get(progress),
+        [&](const uint32_t& id_a, const uint32_t& id_b, const uint64_t& intersection) {
 
         // From https://stats.stackexchange.com/questions/58706/distance-metrics-for-binary-vectors
         const double jaccard = (double)intersection / (double)(bp_count[id_a] + bp_count[id_b] - intersection);
@@ -284,14 +228,15 @@ args::Group threading_opts(parser, "[ Threading ]");
                       << (1.0 - dice) << "\t"
                       << (1.0 - estimated_identity) << "\t"
                       << euclidian_distance << "\t"
-                      << manhattan_distance << std::endl;
+                      << manhattan_distance << "\n";
         } else {
             std::cout << jaccard << "\t"
                       << cosine << "\t"
                       << dice << "\t"
-                      << estimated_identity << std::endl;
+                      << estimated_identity << "\n";
         }
-    }
+    });
+    std::cout.flush();
 
     return 0;
 }
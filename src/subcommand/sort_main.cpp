@@ -12,6 +12,7 @@
 #include "algorithms/xp.hpp"
 #include "algorithms/path_sgd.hpp"
 #include "algorithms/groom.hpp"
+#include "algorithms/instrumentation.hpp"
 
 namespace odgi {
 
@@ -343,7 +344,9 @@ int main_sort(int argc, char** argv) {
             path_index.load(in);
             in.close();
         } else {
+            algorithms::instrumentation::Phase phase("path_index");
             path_index.from_handle_graph(graph, num_threads);
+            phase.add_items(graph.get_path_count());
         }
         fresh_path_index = true;
         // do we only want so sample from a subset of paths?
@@ -408,6 +411,8 @@ int main_sort(int argc, char** argv) {
         path_sgd_max_eta = args::get(p_sgd_eta_max) ? args::get(p_sgd_eta_max) : max_path_step_count * max_path_step_count;
     }
 
+    algorithms::instrumentation::Phase sort_phase("sort");
+    sort_phase.add_items(graph.get_node_count());
     // is it a pipeline of sorts?
     if (!args::get(pipeline).empty()) {
         // for each sort type, apply it to the graph
@@ -483,7 +488,7 @@ int main_sort(int argc, char** argv) {
                     std::reverse(order.begin(), order.end());
                     break;
                 case 'g': {
-                    order = algorithms::groom(graph, progress, target_paths);
+                    order = algorithms::groom(graph, progress, target_paths, true, num_threads);
                     break;
                 }
                 default:
@@ -569,6 +574,9 @@ int main_sort(int argc, char** argv) {
         graph.apply_path_ordering(
                 algorithms::prefix_and_id_ordered_paths(graph, args::get(path_delim), true, true));
     }
+    sort_phase.end();
+    algorithms::instrumentation::Phase write_phase("write");
+    write_phase.add_items(graph.get_node_count());
     const std::string outfile = args::get(dg_out_file);
     if (outfile == "-") {
         graph.serialize(std::cout);
@@ -205,26 +205,34 @@ int main_stats(int argc, char** argv) {
     }
 
     if (args::get(_weakly_connected_components) || _multiqc) {
-        std::vector<ska::flat_hash_set<handlegraph::nid_t>> weak_components = algorithms::weakly_connected_components(&graph);
+        uint64_t n_components = 0;
+        std::vector<handlegraph::nid_t> component_members;
+        std::vector<uint64_t> component_offsets;
+        {
+            const std::vector<uint64_t> component_ids = algorithms::weakly_connected_component_ids(graph, n_components, num_threads);
+            algorithms::weakly_connected_component_members(graph, component_ids, n_components, component_members, component_offsets);
+        }
 		if (_multiqc || _yaml) {
-			std::cout << "num_weakly_connected_components: " << weak_components.size() << std::endl;
+			std::cout << "num_weakly_connected_components: " << n_components << std::endl;
 			std::cout << "weakly_connected_components: " << std::endl;
 		} else {
-			std::cout << "##num_weakly_connected_components: " << weak_components.size() << std::endl;
+			std::cout << "##num_weakly_connected_components: " << n_components << std::endl;
 			std::cout << "#component\tnodes\tis_acyclic" << std::endl;
 		}
-        for(uint64_t i = 0; i < weak_components.size(); ++i) {
-            auto& weak_component = weak_components[i];
+        for(uint64_t i = 0; i < n_components; ++i) {
+            // only one component is held as a set at a time
+            const ska::flat_hash_set<handlegraph::nid_t> weak_component(component_members.begin() + component_offsets[i],
+                                                                        component_members.begin() + component_offsets[i + 1]);
 
-            ska::flat_hash_set<handlegraph::nid_t> head_nodes = algorithms::is_nice_and_acyclic(graph, weak_components[i]);
+            ska::flat_hash_set<handlegraph::nid_t> head_nodes = algorithms::is_nice_and_acyclic(graph, weak_component);
             bool acyclic = !(head_nodes.empty());
 			if (_multiqc || _yaml) {
 				std::cout << "  - component:" << std::endl;
 				std::cout << "      id: " << i << std::endl;
-				std::cout << "      nodes: " << weak_components[i].size() << std::endl;
+				std::cout << "      nodes: " << weak_component.size() << std::endl;
 				std::cout << "      is_acyclic: " << (acyclic ? "'yes'" : "'no'") << std::endl;
 			} else {
-				std::cout << i << "\t" << weak_components[i].size() << "\t" << (acyclic ? "yes" : "no") << std::endl;
+				std::cout << i << "\t" << weak_component.size() << "\t" << (acyclic ? "yes" : "no") << std::endl;
 			}
         }
     }
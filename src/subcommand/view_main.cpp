@@ -73,7 +73,7 @@ int main_view(int argc, char** argv) {
         graph.display();
     }
     if (args::get(to_gfa)) {
-        graph.to_gfa(std::cout, args::get(emit_node_annotation));
+        graph.to_gfa(std::cout, args::get(emit_node_annotation), num_threads);
     }
 
     return 0;
@@ -238,6 +238,7 @@ namespace odgi {
         }
 
 		const uint64_t num_threads = args::get(nthreads) ? args::get(nthreads) : 1;
+        omp_set_num_threads(num_threads);
 
         //NOTE: this sample will overwrite the file or test.png without warning!
         //const char* filename = argc > 1 ? argv[1] : "test.png";
@@ -888,23 +889,29 @@ namespace odgi {
         const bool _color_by_mean_inversion_rate = args::get(color_by_mean_inversion_rate);
         const bool _color_by_uncalled_bases = args::get(color_by_uncalled_bases);
 
+        // the paths drawn on each row, in path order; rows are drawn in parallel, and the paths sharing a row
+        // (through grouping) by the same thread, so that the image does not depend on the number of threads
+        std::vector<std::vector<path_handle_t>> row_paths(path_count);
+        graph.for_each_path_handle([&](const path_handle_t &path) {
+            int64_t path_rank = get_path_idx(path);
+            if (path_rank >= 0 && path_layout_y[path_rank] >= 0){
+                row_paths[path_layout_y[path_rank]].push_back(path);
+            }
+        });
+
         uint64_t longest_path_len = 0;
         if ((_change_darkness && _longest_path) || (_binned_mode && _color_by_mean_depth)){
-            graph.for_each_path_handle([&](const path_handle_t &path) {
-                int64_t path_rank = get_path_idx(path);
-                if (path_rank >= 0 && path_layout_y[path_rank] >= 0){
-                    uint64_t curr_len = 0, p, hl;
-                    handle_t h;
+#pragma omp parallel for schedule(dynamic,1) num_threads(num_threads) reduction(max:longest_path_len)
+            for (uint64_t row = 0; row < row_paths.size(); ++row) {
+                for (auto &path : row_paths[row]) {
+                    uint64_t curr_len = 0;
                     graph.for_each_step_in_path(path, [&](const step_handle_t &occ) {
-                        h = graph.get_handle_of_step(occ);
-                        hl = graph.get_length(h);
-
-                        curr_len += hl;
+                        curr_len += graph.get_length(graph.get_handle_of_step(occ));
                     });
 
                     longest_path_len = std::max(longest_path_len, curr_len);
                 }
-            });
+            }
         }
 
         uint64_t gap_links_removed = 0;
@@ -913,19 +920,20 @@ namespace odgi {
 
 		// Compressed-Mode part starts here :)
 		if (compress) {
-			std::map <uint64_t, algorithms::path_info_t> bins;
-			graph.for_each_path_handle([&](const path_handle_t &path) {
-				graph.for_each_step_in_path(path, [&](const step_handle_t &occ) {
-					handle_t h = graph.get_handle_of_step(occ);
-					uint64_t hl = graph.get_length(h);
-
-					uint64_t p = position_map[number_bool_packing::unpack_number(h) - shift];
+			// every step on a node adds its bases to the bins, so we can sum over the nodes in parallel
+			std::vector<uint64_t> bin_depths((uint64_t) ((len ? len - 1 : 0) / _bin_width) + 2, 0);
+			graph.for_each_handle([&](const handle_t &h) {
+				const uint64_t step_count = graph.get_step_count(h);
+				if (step_count) {
+					const uint64_t hl = graph.get_length(h);
+					const uint64_t p = position_map[number_bool_packing::unpack_number(h) - shift];
 					for (uint64_t k = 0; k < hl; ++k) {
-						int64_t curr_bin = (p + k) / _bin_width + 1;
-						++bins[curr_bin].mean_depth;
+						const int64_t curr_bin = (p + k) / _bin_width + 1;
+#pragma omp atomic
+						bin_depths[curr_bin] += step_count;
 					}
-				});
-			});
+				}
+			}, true);
 
 			/// path name part
 
@@ -987,39 +995,37 @@ namespace odgi {
 				depth += 1;
 			}
 
-			for (auto &entry: bins) {
-				auto &sec = entry.second;
-				auto &curr_bin = entry.first;
-				sec.mean_depth /= _bin_width;
-				// std::cerr << "MEAN DEPTH OF BIN: " << v.mean_depth << std::endl;
-				auto &mean_depth = sec.mean_depth;
+			// pick the color of each bin in parallel, then draw the bins in order, as neighboring bins can share a pixel
+			std::vector<uint8_t> bin_colors(bin_depths.size(), 0);
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+			for (uint64_t curr_bin = 0; curr_bin < bin_depths.size(); ++curr_bin) {
+				const double mean_depth = (double) bin_depths[curr_bin] / _bin_width;
 				uint64_t j = 0;
 				for (; j < cov_cuts.size(); ++j) {
 					if (mean_depth <= cov_cuts[j]) {
-						auto &v = cov_colors[j];
-						path_r = v.red;
-						path_g = v.green;
-						path_b = v.blue;
 						break;
 					}
 				}
 				// take the max color
-				if (j == cov_cuts.size()) {
-					auto &v = cov_colors[j - 1];
+				bin_colors[curr_bin] = std::min(j, cov_cuts.size() - 1);
+			}
+			for (uint64_t curr_bin = 0; curr_bin < bin_depths.size(); ++curr_bin) {
+				if (bin_depths[curr_bin]) {
+					auto &v = cov_colors[bin_colors[curr_bin]];
 					path_r = v.red;
 					path_g = v.green;
 					path_b = v.blue;
+					uint64_t path_y = path_layout_y[path_rank];
+					add_path_step(image, width, curr_bin - 1 - pangenomic_start_pos, path_y,
+								  (float) path_r * x, (float) path_g * x, (float) path_b * x);
 				}
-				uint64_t path_y = path_layout_y[path_rank];
-				add_path_step(image, width, curr_bin - 1 - pangenomic_start_pos, path_y,
-							  (float) path_r * x, (float) path_g * x, (float) path_b * x);
 			}
 			/// end compressed-mode
 
 			/// default case:
 		} else {
 
-			graph.for_each_path_handle([&](const path_handle_t &path) {
+			auto draw_path = [&](const path_handle_t &path) {
 				int64_t path_rank = get_path_idx(path);
 				//std::cerr << graph.get_path_name(path) << " -> " << path_rank << std::endl;
 				if (path_rank >= 0 && path_layout_y[path_rank] >= 0) {
@@ -1368,8 +1374,14 @@ namespace odgi {
 					}
 				}
 				//add_point(curr_bin - 1 - pangenomic_start_pos, 0, RGB_BIN_LINKS, RGB_BIN_LINKS, RGB_BIN_LINKS);
-			});
+			};
 
+#pragma omp parallel for schedule(dynamic,1) num_threads(num_threads)
+			for (uint64_t row = 0; row < row_paths.size(); ++row) {
+				for (auto &path : row_paths[row]) {
+					draw_path(path);
+				}
+			}
 		}
 
         /*
@@ -0,0 +1,67 @@
+/**
+ * \file
+ * unittest/atomic_pointer_table.cpp: test cases for the dense table behind the path metadata.
+ */
+
+#include "catch.hpp"
+
+#include <omp.h>
+#include "atomic_pointer_table.hpp"
+#include "odgi.hpp"
+
+namespace odgi {
+	namespace unittest {
+
+		using namespace std;
+
+		TEST_CASE("The atomic pointer table grows across segments while written concurrently.", "[atomic_pointer_table]") {
+			const uint64_t n = 100000;
+			std::vector<uint64_t> values(n);
+			atomic_pointer_table_t<uint64_t> table;
+			REQUIRE(table.get(0) == nullptr);
+			REQUIRE(table.get(n * 10) == nullptr);
+#pragma omp parallel for num_threads(4)
+			for (uint64_t i = 0; i < n; ++i) {
+				values[i] = i;
+				table.set(i, &values[i]);
+			}
+			bool all_found = true;
+			for (uint64_t i = 0; i < n; ++i) {
+				all_found &= table.get(i) == &values[i];
+			}
+			REQUIRE(all_found);
+			table.set(63, nullptr);
+			REQUIRE(table.get(63) == nullptr);
+			REQUIRE(*table.get(64) == 64);
+			table.clear();
+			REQUIRE(table.get(64) == nullptr);
+		}
+
+		TEST_CASE("Path metadata stays reachable through creation, destruction and reordering of paths.", "[atomic_pointer_table]") {
+			graph_t graph;
+			handle_t h = graph.create_handle("A");
+			std::vector<path_handle_t> paths;
+			for (uint64_t i = 0; i < 200; ++i) {
+				paths.push_back(graph.create_path_handle("p" + std::to_string(i)));
+				graph.append_step(paths.back(), h);
+			}
+			REQUIRE(graph.get_path_name(paths[150]) == "p150");
+			REQUIRE(graph.get_step_count(paths[150]) == 1);
+
+			graph.destroy_path(paths[10]);
+			uint64_t count = 0;
+			graph.for_each_path_handle([&](const path_handle_t& p) {
+				++count;
+				REQUIRE(p != paths[10]);
+			});
+			REQUIRE(count == 199);
+			REQUIRE(!graph.has_path("p10"));
+			REQUIRE(graph.get_path_handle("p199") == paths[199]);
+
+			graph.clear_paths();
+			REQUIRE(graph.get_path_count() == 0);
+			path_handle_t p = graph.create_path_handle("again");
+			REQUIRE(graph.get_path_name(p) == "again");
+		}
+	}
+}
@@ -0,0 +1,91 @@
+/**
+ * \file
+ * unittest/bed_intervals.cpp: test cases for reading sorted BED records and sweeping them along paths.
+ */
+
+#include "catch.hpp"
+
+#include <sstream>
+#include <vector>
+#include <tuple>
+#include "odgi.hpp"
+#include "algorithms/bed_intervals.hpp"
+
+namespace odgi {
+namespace unittest {
+
+using namespace std;
+using namespace handlegraph;
+
+TEST_CASE("Sorted BED records are grouped by sequence", "[bed_intervals]") {
+    std::stringstream bed;
+    bed << "track name=test" << std::endl
+        << "# comment" << std::endl
+        << "x\t0\t5\tx1" << std::endl
+        << "x\t3\t4\tx2" << std::endl
+        << std::endl
+        << "y\t2\t9\ty1" << std::endl
+        << "skip\t0\t1\ts1" << std::endl
+        << "y\t1\t2\ty2" << std::endl
+        << "x\t8\t10\tx3" << std::endl;
+
+    std::vector<algorithms::bed_sequence_t> sequences;
+    std::vector<std::string> names;
+    algorithms::read_sorted_bed(bed, 3, "test",
+                                [](const std::string& name) { return name != "skip"; },
+                                sequences, &names);
+
+    REQUIRE(sequences.size() == 2);
+    REQUIRE(sequences[0].name == "x");
+    REQUIRE(sequences[0].intervals.size() == 3);
+    REQUIRE(sequences[0].intervals[1].start == 3);
+    REQUIRE(sequences[0].intervals[2].name == "x3");
+    // y arrived out of order and is sorted
+    REQUIRE(sequences[1].name == "y");
+    REQUIRE(sequences[1].intervals[0].name == "y2");
+    REQUIRE(sequences[1].intervals[1].name == "y1");
+    REQUIRE(names == std::vector<std::string>({"x1", "x2", "y1", "y2", "x3"}));
+}
+
+TEST_CASE("Intervals are matched to steps in one walk along the path", "[bed_intervals]") {
+    graph_t g;
+    handle_t n1 = g.create_handle("CGA");
+    handle_t n2 = g.create_handle("TTGG");
+    handle_t n3 = g.create_handle("CC");
+    g.create_edge(n1, n2);
+    g.create_edge(n2, n3);
+    path_handle_t p = g.create_path_handle("p");
+    g.append_step(p, n1);
+    g.append_step(p, n2);
+    g.append_step(p, n3);
+
+    std::vector<algorithms::bed_interval_t> intervals = {
+        {0, 3, "a"},    // exactly the first node
+        {2, 5, "b"},    // from the end of the first node into the second
+        {7, 12, "c"},   // from the last node past the end of the path
+        {9, 10, "d"}    // beyond the path
+    };
+    // (interval, node id, offset) of each start and (interval, node id, offset, clipped) of each end
+    std::vector<std::tuple<uint64_t, nid_t, uint64_t>> starts;
+    std::vector<std::tuple<uint64_t, nid_t, uint64_t, bool>> ends;
+    algorithms::sweep_path_intervals(
+        g, p, intervals,
+        [&](const uint64_t& i, const step_handle_t& step, const uint64_t& offset) {
+            starts.push_back(std::make_tuple(i, g.get_id(g.get_handle_of_step(step)), offset));
+        },
+        [&](const uint64_t& i, const step_handle_t& step, const uint64_t& offset, const bool& clipped) {
+            ends.push_back(std::make_tuple(i, g.get_id(g.get_handle_of_step(step)), offset, clipped));
+        });
+
+    REQUIRE(starts.size() == 3);
+    REQUIRE(starts[0] == std::make_tuple((uint64_t)0, (nid_t)1, (uint64_t)0));
+    REQUIRE(starts[1] == std::make_tuple((uint64_t)1, (nid_t)1, (uint64_t)2));
+    REQUIRE(starts[2] == std::make_tuple((uint64_t)2, (nid_t)3, (uint64_t)0));
+    REQUIRE(ends.size() == 3);
+    REQUIRE(ends[0] == std::make_tuple((uint64_t)0, (nid_t)1, (uint64_t)3, false));
+    REQUIRE(ends[1] == std::make_tuple((uint64_t)1, (nid_t)2, (uint64_t)2, false));
+    REQUIRE(ends[2] == std::make_tuple((uint64_t)2, (nid_t)3, (uint64_t)2, true));
+}
+
+}
+}
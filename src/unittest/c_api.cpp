@@ -0,0 +1,101 @@
+/**
+ * \file
+ * unittest/c_api.cpp: test cases for the batch calls of the C interface.
+ */
+
+#include "catch.hpp"
+
+#include <cstring>
+#include <handlegraph/util.hpp>
+#include "odgi.hpp"
+#include "odgi-api.h"
+
+namespace odgi {
+	namespace unittest {
+
+		using namespace std;
+		using namespace handlegraph;
+
+		TEST_CASE("The C interface fills caller-provided buffers.", "[c_api]") {
+
+			graph_t graph;
+			handle_t h1 = graph.create_handle("A");
+			handle_t h2 = graph.create_handle("CC");
+			handle_t h3 = graph.create_handle("GTT");
+			graph.create_edge(h1, h2);
+			graph.create_edge(h1, graph.flip(h3));
+			graph.create_edge(h2, h3);
+			path_handle_t x = graph.create_path_handle("x");
+			for (auto& h : {h1, h2, h3}) {
+				graph.append_step(x, h);
+			}
+			path_handle_t y = graph.create_path_handle("circular", true);
+			for (auto& h : {h1, graph.flip(h3)}) {
+				graph.append_step(y, h);
+			}
+			const odgi_c_graph* g = as_c_graph(&graph);
+
+			SECTION("List sizes can be queried with an empty buffer.") {
+				REQUIRE(odgi_c_get_handles(g, nullptr, 0) == 3);
+				REQUIRE(odgi_c_get_path_handles(g, nullptr, 0) == 2);
+				REQUIRE(odgi_c_get_path_name(g, as_integer(y), nullptr, 0) == 8);
+				uint64_t handles[2];
+				REQUIRE(odgi_c_get_handles(g, handles, 2) == 3);
+				REQUIRE(handles[0] == as_integer(h1));
+				REQUIRE(handles[1] == as_integer(h2));
+				char name[9];
+				REQUIRE(odgi_c_get_path_name(g, as_integer(y), name, 9) == 8);
+				REQUIRE(std::string(name) == "circular");
+			}
+
+			SECTION("Sequences are concatenated at the given offsets.") {
+				const uint64_t handles[3] = {as_integer(h1), as_integer(graph.flip(h3)), as_integer(h2)};
+				uint64_t offsets[4];
+				char seq[6];
+				REQUIRE(odgi_c_get_sequences(g, handles, 3, offsets, seq, 6) == 6);
+				REQUIRE(std::string(seq, 6) == "AAACCC");
+				REQUIRE(offsets[1] == 1);
+				REQUIRE(offsets[2] == 4);
+				uint64_t lengths[3];
+				odgi_c_get_lengths(g, handles, 3, lengths);
+				REQUIRE(lengths[1] == 3);
+			}
+
+			SECTION("The edges of many handles are returned at once.") {
+				const uint64_t handles[2] = {as_integer(h1), as_integer(h3)};
+				uint64_t offsets[3];
+				uint64_t neighbors[3];
+				REQUIRE(odgi_c_get_edges(g, handles, 2, 0, offsets, nullptr, 0) == 3);
+				REQUIRE(odgi_c_get_edges(g, handles, 2, 1, offsets, neighbors, 3) == 1);
+				REQUIRE(offsets[1] == 0);
+				REQUIRE(neighbors[0] == as_integer(h2));
+			}
+
+			SECTION("Paths can be read at once or in batches, also when they are circular.") {
+				odgi_c_step steps[3];
+				REQUIRE(odgi_c_get_path_steps(g, as_integer(x), steps, 3) == 3);
+				REQUIRE(steps[2].handle == as_integer(h3));
+				uint64_t paths[3];
+				odgi_c_get_paths_of_steps(g, steps, 3, paths);
+				REQUIRE(paths[0] == as_integer(x));
+
+				odgi_c_path_cursor cursor = odgi_c_path_cursor_begin(g, as_integer(y));
+				uint64_t handles[1];
+				REQUIRE(odgi_c_path_cursor_next(g, &cursor, handles, 1) == 1);
+				REQUIRE(handles[0] == as_integer(h1));
+				REQUIRE(odgi_c_path_cursor_next(g, &cursor, handles, 1) == 1);
+				REQUIRE(handles[0] == as_integer(graph.flip(h3)));
+				REQUIRE(odgi_c_path_cursor_next(g, &cursor, handles, 1) == 0);
+			}
+
+			SECTION("The steps on many handles are returned at once.") {
+				const uint64_t handles[2] = {as_integer(h1), as_integer(h2)};
+				uint64_t offsets[3];
+				odgi_c_step steps[3];
+				REQUIRE(odgi_c_get_steps_on_handles(g, handles, 2, offsets, steps, 3) == 3);
+				REQUIRE(offsets[1] == 2);
+				REQUIRE(steps[2].handle == as_integer(h2));
+			}
+		}
+	}
+}
@@ -0,0 +1,106 @@
+/**
+ * \file
+ * unittest/depth_index.cpp: test cases for the implementation of the depth index.
+ */
+
+#include "catch.hpp"
+
+#include <handlegraph/util.hpp>
+#include "odgi.hpp"
+#include "algorithms/depth_index.hpp"
+#include "algorithms/xp.hpp"
+
+namespace odgi {
+	namespace unittest {
+
+		using namespace std;
+		using namespace handlegraph;
+		using namespace algorithms;
+
+		TEST_CASE("depth index construction, range queries, serialization and loading.", "[depthindex]") {
+
+			graph_t graph;
+			handle_t n1 = graph.create_handle("CAA");
+			handle_t n2 = graph.create_handle("A");
+			handle_t n3 = graph.create_handle("GT");
+			graph.create_edge(n1, n1);
+			graph.create_edge(n1, n2);
+			graph.create_edge(n1, n3);
+			graph.create_edge(n2, n3);
+
+			path_handle_t p1 = graph.create_path_handle("p1", false);
+			graph.append_step(p1, n1);
+			graph.append_step(p1, n2);
+			graph.append_step(p1, n3);
+
+			path_handle_t p2 = graph.create_path_handle("p2", false);
+			graph.append_step(p2, n1);
+			graph.append_step(p2, n3);
+
+			path_handle_t p3 = graph.create_path_handle("p3", false);
+			graph.append_step(p3, n1);
+			graph.append_step(p3, n1);
+
+			auto range = [&](const path_handle_t& path, const uint64_t& begin, const uint64_t& end) {
+				return path_range_t{{path, begin, false}, {path, end, false}, false, ".", ""};
+			};
+
+			auto check_index = [&](const depth_index_t& depth_index) {
+				REQUIRE(depth_index.is_compatible(graph));
+
+				REQUIRE(depth_index.get_node_depth(1) == 4);
+				REQUIRE(depth_index.get_node_depth_uniq(1) == 3);
+				REQUIRE(depth_index.get_node_depth(2) == 1);
+				REQUIRE(depth_index.get_node_depth_uniq(2) == 1);
+				REQUIRE(depth_index.get_node_depth(3) == 2);
+				REQUIRE(depth_index.get_node_depth_uniq(3) == 2);
+
+				REQUIRE(depth_index.get_path_length(p1) == 6);
+				REQUIRE(depth_index.get_path_length(p2) == 5);
+				REQUIRE(depth_index.get_path_length(p3) == 6);
+
+				REQUIRE(depth_index.get_node_at(p1, 0) == 1);
+				REQUIRE(depth_index.get_node_at(p1, 3) == 2);
+				REQUIRE(depth_index.get_node_at(p1, 5) == 3);
+				REQUIRE(depth_index.get_node_at(p1, 6) == 0);
+
+				// p1: 4 4 4 1 2 2
+				REQUIRE(depth_index.get_depth_prefix(p1, 0) == 0);
+				REQUIRE(depth_index.get_depth_prefix(p1, 2) == 8);
+				REQUIRE(depth_index.get_depth_prefix(p1, 4) == 13);
+				REQUIRE(depth_index.get_depth_prefix(p1, 6) == 17);
+				REQUIRE(depth_index.get_mean_depth(range(p1, 0, 6)) == Approx(17.0 / 6.0));
+				REQUIRE(depth_index.get_mean_depth(range(p1, 2, 5)) == Approx(7.0 / 3.0));
+				// p2: 4 4 4 2 2
+				REQUIRE(depth_index.get_mean_depth(range(p2, 1, 4)) == Approx(10.0 / 3.0));
+				// p3: 4 4 4 4 4 4
+				REQUIRE(depth_index.get_mean_depth(range(p3, 0, 6)) == Approx(4.0));
+			};
+
+			SECTION("The index delivers the correct node and range depths.") {
+				depth_index_t depth_index(graph, {}, 1, false);
+				check_index(depth_index);
+			}
+
+			SECTION("The index honors a subset of paths.") {
+				std::vector<bool> paths_to_consider(graph.get_path_count() + 1, false);
+				paths_to_consider[as_integer(p1)] = true;
+				depth_index_t depth_index(graph, paths_to_consider, 1, false);
+				REQUIRE(depth_index.get_node_depth(1) == 1);
+				REQUIRE(depth_index.get_node_depth(3) == 1);
+				// p3 walks only nodes of depth 1 now
+				REQUIRE(depth_index.get_mean_depth(range(p3, 0, 6)) == Approx(1.0));
+			}
+
+			SECTION("The index can be saved and loaded.") {
+				depth_index_t depth_index_to_save(graph, {}, 1, false);
+				std::string basename = xp::temp_file::create();
+				depth_index_to_save.save(basename + "unittest.dpidx");
+
+				depth_index_t depth_index_loaded;
+				depth_index_loaded.load(basename + "unittest.dpidx");
+				check_index(depth_index_loaded);
+			}
+		}
+	}
+}
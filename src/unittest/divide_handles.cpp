@@ -0,0 +1,151 @@
+/**
+ * \file
+ * unittest/divide_handles.cpp: test cases for dividing many nodes at once.
+ */
+
+#include "catch.hpp"
+
+#include <string>
+#include <vector>
+#include "odgi.hpp"
+#include "algorithms/chop.hpp"
+
+namespace odgi {
+namespace unittest {
+
+using namespace std;
+using namespace handlegraph;
+
+// the oriented sequences of the steps of each path
+static vector<vector<string>> path_step_sequences(const graph_t& graph) {
+    vector<vector<string>> paths;
+    graph.for_each_path_handle([&](const path_handle_t& path) {
+        paths.emplace_back();
+        graph.for_each_step_in_path(path, [&](const step_handle_t& step) {
+            paths.back().push_back(graph.get_sequence(graph.get_handle_of_step(step)));
+        });
+    });
+    return paths;
+}
+
+// every pair of consecutive steps is joined by an edge
+static bool paths_follow_edges(const graph_t& graph) {
+    bool ok = true;
+    graph.for_each_path_handle([&](const path_handle_t& path) {
+        step_handle_t step = graph.path_begin(path);
+        while (graph.has_next_step(step)) {
+            step_handle_t next = graph.get_next_step(step);
+            ok &= graph.has_edge(graph.get_handle_of_step(step), graph.get_handle_of_step(next));
+            step = next;
+        }
+    });
+    return ok;
+}
+
+TEST_CASE("Dividing many handles at once keeps the paths and edges", "[divide_handles]") {
+    graph_t graph;
+    handle_t h1 = graph.create_handle("GATTACA");
+    handle_t h2 = graph.create_handle("CC");
+    handle_t h3 = graph.create_handle("TTTTGGGG");
+    handle_t h4 = graph.create_handle("ACGTACGT");
+    graph.create_edge(h1, h2);
+    graph.create_edge(h2, h3);
+    graph.create_edge(h1, h3);
+    graph.create_edge(h2, graph.flip(h4));      // an inversion
+    graph.create_edge(h3, h4);
+    graph.create_edge(h4, h4);                  // a self loop
+    graph.create_edge(h4, graph.flip(h4));      // an inverting self loop
+
+    path_handle_t p = graph.create_path_handle("p");
+    graph.append_step(p, h1);
+    graph.append_step(p, h2);
+    graph.append_step(p, h3);
+    graph.append_step(p, h4);
+    graph.append_step(p, h4);
+    path_handle_t q = graph.create_path_handle("q");
+    graph.append_step(q, graph.flip(h4));
+    graph.append_step(q, graph.flip(h3));
+    graph.append_step(q, graph.flip(h1));
+    path_handle_t r = graph.create_path_handle("r");
+    graph.append_step(r, h4);
+    graph.append_step(r, graph.flip(h4));
+
+    graph.set_number_of_threads(2);
+    auto parts = graph.divide_handles({
+            { h1, {3} },
+            { graph.flip(h3), {2, 5} },
+            { h4, {4} },
+            { h2, {} } });
+
+    const vector<vector<string>> expected = {
+        { "GAT", "TACA", "CC", "TTT", "TGG", "GG", "ACGT", "ACGT", "ACGT", "ACGT" },
+        { "ACGT", "ACGT", "CC", "CCA", "AAA", "TGTA", "ATC" },
+        { "ACGT", "ACGT", "ACGT", "ACGT" }
+    };
+
+    SECTION("the parts come in the order and orientation of the given handles") {
+        REQUIRE(parts.size() == 4);
+        REQUIRE(parts[0].size() == 2);
+        REQUIRE(graph.get_sequence(parts[0][0]) == "GAT");
+        REQUIRE(graph.get_sequence(parts[0][1]) == "TACA");
+        REQUIRE(parts[1].size() == 3);
+        REQUIRE(graph.get_sequence(parts[1][0]) == "CC");
+        REQUIRE(graph.get_sequence(parts[1][1]) == "CCA");
+        REQUIRE(graph.get_sequence(parts[1][2]) == "AAA");
+        REQUIRE(parts[3].size() == 1);
+        REQUIRE(parts[3][0] == h2);
+    }
+
+    SECTION("the paths walk the pieces along the edges") {
+        REQUIRE(graph.get_node_count() == 8);
+        // the original edges and one between each pair of consecutive pieces
+        REQUIRE(graph.get_edge_count() == 7 + 4);
+        REQUIRE(path_step_sequences(graph) == expected);
+        REQUIRE(graph.get_step_count(p) == 10);
+        REQUIRE(graph.get_step_count(q) == 7);
+        REQUIRE(graph.get_step_count(r) == 4);
+        REQUIRE(paths_follow_edges(graph));
+        REQUIRE(graph.has_edge(parts[2][1], parts[2][0]));
+        REQUIRE(graph.has_edge(parts[2][1], graph.flip(parts[2][1])));
+        REQUIRE(graph.has_edge(h2, graph.flip(parts[2][1])));
+    }
+
+    SECTION("the divided graph can be optimized") {
+        graph.optimize();
+        REQUIRE(graph.get_node_count() == 8);
+        REQUIRE(path_step_sequences(graph) == expected);
+        REQUIRE(paths_follow_edges(graph));
+    }
+}
+
+TEST_CASE("Chop divides all long nodes in parallel", "[divide_handles]") {
+    graph_t graph;
+    handle_t h1 = graph.create_handle("GATTACAGATTACA");
+    handle_t h2 = graph.create_handle("C");
+    handle_t h3 = graph.create_handle("TTTTGGGGA");
+    graph.create_edge(h1, h2);
+    graph.create_edge(h2, h3);
+    graph.create_edge(h1, h3);
+    path_handle_t p = graph.create_path_handle("p");
+    graph.append_step(p, h1);
+    graph.append_step(p, h2);
+    graph.append_step(p, h3);
+
+    algorithms::chop(graph, 4, 2, false);
+
+    std::string seq;
+    graph.for_each_handle([&](const handle_t& h) {
+        REQUIRE(graph.get_length(h) <= 4);
+        seq += graph.get_sequence(h);
+    });
+    // the pieces keep the order of their nodes
+    REQUIRE(seq == "GATTACAGATTACACTTTTGGGGA");
+    REQUIRE(graph.get_node_count() == 4 + 1 + 3);
+    REQUIRE(graph.get_step_count(p) == 8);
+    REQUIRE(graph.min_node_id() == 1);
+    REQUIRE(graph.max_node_id() == 8);
+    REQUIRE(paths_follow_edges(graph));
+}
+
+}
+}
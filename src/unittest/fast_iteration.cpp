@@ -0,0 +1,104 @@
+/**
+ * \file
+ * unittest/fast_iteration.cpp: test cases for the templated iteration functions of graph_t.
+ */
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <handlegraph/util.hpp>
+#include "odgi.hpp"
+
+namespace odgi {
+	namespace unittest {
+
+		using namespace std;
+		using namespace handlegraph;
+
+		TEST_CASE("The fast iteration functions agree with the std::function ones.", "[fast_iteration]") {
+
+			graph_t graph;
+			handle_t h1 = graph.create_handle("A");
+			handle_t h2 = graph.create_handle("CC");
+			handle_t h3 = graph.create_handle("G");
+			handle_t h4 = graph.create_handle("TT");
+			graph.create_edge(h1, h2);
+			graph.create_edge(h1, graph.flip(h3));
+			graph.create_edge(h2, h4);
+			graph.create_edge(graph.flip(h3), h4);
+			graph.create_edge(h4, h4);
+			graph.create_edge(h2, graph.flip(h2));
+			graph.create_edge(graph.flip(h1), h1);
+			path_handle_t x = graph.create_path_handle("x");
+			for (auto& h : {h1, h2, h4, h4}) {
+				graph.append_step(x, h);
+			}
+			path_handle_t y = graph.create_path_handle("y", true);
+			for (auto& h : {h1, graph.flip(h3), h4}) {
+				graph.append_step(y, h);
+			}
+
+			SECTION("Following edges gives the same handles.") {
+				std::vector<handle_t> buffer;
+				graph.for_each_handle([&](const handle_t& h) {
+					for (auto& handle : {h, graph.flip(h)}) {
+						for (bool go_left : {false, true}) {
+							std::vector<handle_t> slow, fast;
+							graph.follow_edges(handle, go_left, [&](const handle_t& o) { slow.push_back(o); });
+							graph.follow_edges_fast(handle, go_left, [&](const handle_t& o) { fast.push_back(o); });
+							REQUIRE(fast == slow);
+							REQUIRE(graph.get_edges(handle, go_left, buffer) == slow.size());
+							REQUIRE(buffer == slow);
+						}
+					}
+				});
+			}
+
+			SECTION("Each edge is visited once, as in for_each_edge.") {
+				std::vector<edge_t> slow, fast;
+				graph.for_each_edge([&](const edge_t& e) { slow.push_back(e); });
+				graph.for_each_edge_fast([&](const edge_t& e) { fast.push_back(e); });
+				std::sort(slow.begin(), slow.end());
+				std::sort(fast.begin(), fast.end());
+				REQUIRE(fast == slow);
+				REQUIRE(fast.size() == 7);
+			}
+
+			SECTION("The steps on a handle are the same.") {
+				std::vector<step_handle_t> buffer;
+				graph.for_each_handle([&](const handle_t& h) {
+					std::vector<step_handle_t> slow, fast;
+					graph.for_each_step_on_handle(h, [&](const step_handle_t& s) { slow.push_back(s); });
+					graph.for_each_step_on_handle_fast(h, [&](const step_handle_t& s) { fast.push_back(s); });
+					REQUIRE(fast == slow);
+					REQUIRE(graph.get_steps_on_handle(h, buffer) == slow.size());
+					REQUIRE(buffer == slow);
+				});
+			}
+
+			SECTION("Iteration stops when the iteratee returns false.") {
+				uint64_t visited = 0;
+				REQUIRE(!graph.for_each_handle_fast([&](const handle_t& h) {
+					++visited;
+					return visited < 2;
+				}));
+				REQUIRE(visited == 2);
+				REQUIRE(graph.for_each_handle_fast([&](const handle_t& h) { }));
+			}
+
+			SECTION("Iterating the steps of a path matches for_each_step_in_path, also for circular paths.") {
+				for (auto& path : {x, y}) {
+					std::vector<step_handle_t> slow, fast;
+					graph.for_each_step_in_path(path, [&](const step_handle_t& s) { slow.push_back(s); });
+					for (auto& s : graph.steps_of_path(path)) {
+						fast.push_back(s);
+					}
+					REQUIRE(fast == slow);
+				}
+				path_handle_t empty = graph.create_path_handle("empty");
+				auto steps = graph.steps_of_path(empty);
+				REQUIRE(steps.begin() == steps.end());
+			}
+		}
+	}
+}
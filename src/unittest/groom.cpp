@@ -0,0 +1,52 @@
+/**
+ * \file
+ * unittest/groom.cpp: test cases for grooming node orientations.
+ */
+
+#include "catch.hpp"
+
+#include <vector>
+#include "odgi.hpp"
+#include "algorithms/groom.hpp"
+
+namespace odgi {
+namespace unittest {
+
+using namespace std;
+using namespace handlegraph;
+
+TEST_CASE("Grooming orients every component as a single-threaded search would", "[groom]") {
+    graph_t graph;
+    // a cycle without heads, with an inversion
+    handle_t a1 = graph.create_handle("A");
+    handle_t a2 = graph.create_handle("C");
+    handle_t a3 = graph.create_handle("G");
+    graph.create_edge(a1, a2);
+    graph.create_edge(a2, graph.flip(a3));
+    graph.create_edge(graph.flip(a3), a1);
+    // a linear component that no path visits
+    handle_t b1 = graph.create_handle("T");
+    handle_t b2 = graph.create_handle("TT");
+    graph.create_edge(b1, b2);
+    path_handle_t p = graph.create_path_handle("p");
+    graph.append_step(p, graph.flip(a2));
+    graph.append_step(p, graph.flip(a1));
+
+    for (auto& use_bfs : { true, false }) {
+        SECTION(use_bfs ? "with BFS" : "with DFS") {
+            SECTION("The headless cycle is seeded from its first node") {
+                const vector<handle_t> expected = { a1, a2, graph.flip(a3), b1, b2 };
+                REQUIRE(algorithms::groom(graph, false, {}, use_bfs, 1) == expected);
+                REQUIRE(algorithms::groom(graph, false, {}, use_bfs, 4) == expected);
+            }
+            SECTION("The target path sets its orientation, the component without it is seeded from its first node") {
+                const vector<handle_t> expected = { graph.flip(a1), graph.flip(a2), a3, b1, b2 };
+                REQUIRE(algorithms::groom(graph, false, { p }, use_bfs, 1) == expected);
+                REQUIRE(algorithms::groom(graph, false, { p }, use_bfs, 4) == expected);
+            }
+        }
+    }
+}
+
+}
+}
@@ -0,0 +1,96 @@
+/**
+ * \file
+ * unittest/layout_tiles.cpp: test cases for the implementation of the layout tile pyramid.
+ */
+
+#include "catch.hpp"
+
+#include <handlegraph/util.hpp>
+#include "odgi.hpp"
+#include "algorithms/layout_tiles.hpp"
+#include "algorithms/xp.hpp"
+
+namespace odgi {
+	namespace unittest {
+
+		using namespace std;
+		using namespace handlegraph;
+		using namespace algorithms::layout;
+
+		TEST_CASE("Layout tile pyramids are written and memory-mapped.", "[layouttiles]") {
+
+			graph_t graph;
+			std::vector<handle_t> handles;
+			for (uint64_t i = 0; i < 16; ++i) {
+				handles.push_back(graph.create_handle(i % 2 ? "AC" : "G"));
+			}
+			path_handle_t p = graph.create_path_handle("p", false);
+			for (uint64_t i = 0; i < 16; ++i) {
+				if (i) {
+					graph.create_edge(handles[i - 1], handles[i]);
+				}
+				graph.append_step(p, handles[i]);
+			}
+			path_handle_t q = graph.create_path_handle("q", false);
+			graph.append_step(q, handles[0]);
+
+			// the nodes lie on a 4 x 4 grid of unit cells in [0, 4) x [0, 4), the first node longer than the others
+			std::vector<double> X(32), Y(32);
+			for (uint64_t i = 0; i < 16; ++i) {
+				X[2 * i] = i % 4 + 0.25;
+				X[2 * i + 1] = i % 4 + (i == 0 ? 0.95 : 0.75);
+				Y[2 * i] = Y[2 * i + 1] = i / 4 + 0.5;
+			}
+			// stretch the layout to a square extent of 4
+			X[31] = 4.0;
+			Y[31] = 4.0;
+
+			std::string filename = algorithms::xp::temp_file::create() + "unittest.tiles";
+			REQUIRE(write_layout_tiles(filename, graph, X, Y, 2, 2));
+			// a path that cannot be opened is reported, not silently skipped
+			REQUIRE_FALSE(write_layout_tiles(filename + ".missing/unittest.tiles", graph, X, Y, 2, 2));
+
+			LayoutTiles tiles;
+			REQUIRE(tiles.open(filename));
+			REQUIRE(tiles.header().n_nodes == 16);
+			// 16 nodes with 2 per tile: 1, 4 and 16 tiles
+			REQUIRE(tiles.header().n_levels == 3);
+
+			SECTION("The root tile summarizes the whole graph and keeps its longest segments.") {
+				const layout_tile_t* root = tiles.get_tile(0, 0, 0);
+				REQUIRE(root != nullptr);
+				REQUIRE(root->n_nodes == 16);
+				REQUIRE(root->length == 24);
+				REQUIRE(root->steps == 17);
+				REQUIRE(root->n_paths == 2);
+				REQUIRE(root->n_segments == 2);
+				const layout_tile_segment_t* segments = tiles.segments(*root);
+				REQUIRE((segments[0].id == 1 || segments[1].id == 1));
+			}
+
+			SECTION("The finest tiles hold all of their nodes.") {
+				uint64_t n_segments = 0;
+				tiles.for_each_tile_in_view(2, 0, 0, 4, 4, [&](const layout_tile_t& tile) {
+					REQUIRE(tile.n_segments == tile.n_nodes);
+					n_segments += tile.n_segments;
+				});
+				REQUIRE(n_segments == 16);
+				const layout_tile_t* corner = tiles.get_tile(2, 0, 0);
+				REQUIRE(corner != nullptr);
+				REQUIRE(corner->n_nodes == 1);
+				REQUIRE(corner->n_paths == 2);
+				REQUIRE(tiles.segments(*corner)[0].id == 1);
+			}
+
+			SECTION("A view only visits the tiles it overlaps.") {
+				uint64_t n_tiles = 0;
+				tiles.for_each_tile_in_view(1, 0.1, 0.1, 1.9, 1.9, [&](const layout_tile_t& tile) {
+					++n_tiles;
+					REQUIRE(tile.morton == 0);
+					REQUIRE(tile.n_nodes == 4);
+				});
+				REQUIRE(n_tiles == 1);
+			}
+		}
+	}
+}
@@ -0,0 +1,124 @@
+/**
+ * \file
+ * unittest/matrix_writer.cpp: test cases for the sparse matrix writers.
+ */
+
+#include "catch.hpp"
+
+#include <sstream>
+#include <cstring>
+#include <map>
+#include <handlegraph/util.hpp>
+#include "odgi.hpp"
+#include "algorithms/matrix_writer.hpp"
+
+namespace odgi {
+	namespace unittest {
+
+		using namespace std;
+		using namespace handlegraph;
+		using namespace algorithms;
+
+		TEST_CASE("The CSR matrix holds both directions of every edge, weighted like the text matrix.", "[matrix]") {
+
+			graph_t graph;
+			handle_t n1 = graph.create_handle("A");
+			handle_t n2 = graph.create_handle("C");
+			handle_t n3 = graph.create_handle("G");
+			graph.create_edge(n1, n2);
+			graph.create_edge(n2, n3);
+			graph.create_edge(n1, n3);
+			// x: 1 -> 2 -> 3, y: 1 -> 3, z: 3- -> 2- -> 1-, crossing the edges backwards
+			path_handle_t x = graph.create_path_handle("x");
+			graph.append_step(x, n1);
+			graph.append_step(x, n2);
+			graph.append_step(x, n3);
+			path_handle_t y = graph.create_path_handle("y");
+			graph.append_step(y, n1);
+			graph.append_step(y, n3);
+			path_handle_t z = graph.create_path_handle("z");
+			graph.append_step(z, graph.flip(n3));
+			graph.append_step(z, graph.flip(n2));
+			graph.append_step(z, graph.flip(n1));
+
+			auto check = [&](const uint64_t& nthreads) {
+				sparse_matrix_t matrix = build_sparse_matrix(graph, true, false, nthreads);
+				REQUIRE(matrix.n_rows == 3);
+				REQUIRE(matrix.n_cols == 3);
+				REQUIRE(matrix.offsets == std::vector<uint64_t>({0, 2, 4, 6}));
+				REQUIRE(matrix.columns == std::vector<uint64_t>({1, 2, 0, 2, 0, 1}));
+				REQUIRE(matrix.weights == std::vector<double>({2, 1, 2, 2, 1, 2}));
+
+				matrix = build_sparse_matrix(graph, false, true, nthreads);
+				REQUIRE(matrix.weights == std::vector<double>({1, 0.5, 1, 1, 0.5, 1}));
+			};
+
+			SECTION("Edge depths count the traversals of the paths in either direction.") {
+				check(1);
+			}
+
+			SECTION("The per-thread depth counts give the same matrix.") {
+				check(4);
+			}
+
+			SECTION("The binary file is the header followed by the three arrays.") {
+				const sparse_matrix_t matrix = build_sparse_matrix(graph, false, false, 2);
+				std::stringstream out;
+				write_as_binary_sparse_matrix(out, matrix);
+				const std::string bytes = out.str();
+				REQUIRE(bytes.size() == sizeof(sparse_matrix_header_t) + 4 * 8 + 6 * 8 + 6 * 8);
+				sparse_matrix_header_t header;
+				std::memcpy(&header, bytes.data(), sizeof(header));
+				REQUIRE(std::string(header.magic) == "ODGICSR");
+				REQUIRE(header.nnz == 6);
+				uint64_t last_offset;
+				std::memcpy(&last_offset, bytes.data() + sizeof(header) + 3 * 8, 8);
+				REQUIRE(last_offset == 6);
+			}
+		}
+
+		TEST_CASE("The CSR matrix weights circular paths like the text matrix.", "[matrix]") {
+
+			graph_t graph;
+			handle_t n1 = graph.create_handle("A");
+			handle_t n2 = graph.create_handle("C");
+			handle_t n3 = graph.create_handle("G");
+			graph.create_edge(n1, n2);
+			graph.create_edge(n2, n3);
+			graph.create_edge(n3, n1);
+			// c: 1 -> 2 -> 3, wrapping around over 3 -> 1
+			path_handle_t c = graph.create_path_handle("c", true);
+			graph.append_step(c, n1);
+			graph.append_step(c, n2);
+			graph.append_step(c, n3);
+			path_handle_t x = graph.create_path_handle("x");
+			graph.append_step(x, n2);
+			graph.append_step(x, n3);
+			graph.append_step(x, n1);
+
+			// the text matrix as (row, column) -> weight, with 0-based rows and columns
+			std::stringstream text;
+			write_as_sparse_matrix(text, graph, true, false);
+			std::map<std::pair<uint64_t, uint64_t>, double> expected;
+			uint64_t n_rows, n_cols, n_entries;
+			text >> n_rows >> n_cols >> n_entries;
+			uint64_t row, column;
+			double weight;
+			while (text >> row >> column >> weight) {
+				expected[std::make_pair(row - 1, column - 1)] += weight;
+			}
+			REQUIRE(expected[std::make_pair(2, 0)] == 1);
+
+			for (auto& nthreads : { 1, 4 }) {
+				const sparse_matrix_t matrix = build_sparse_matrix(graph, true, false, nthreads);
+				std::map<std::pair<uint64_t, uint64_t>, double> weights;
+				for (uint64_t i = 0; i < matrix.n_rows; ++i) {
+					for (uint64_t k = matrix.offsets[i]; k < matrix.offsets[i + 1]; ++k) {
+						weights[std::make_pair(i, matrix.columns[k])] += matrix.weights[k];
+					}
+				}
+				REQUIRE(weights == expected);
+			}
+		}
+	}
+}
@@ -0,0 +1,73 @@
+/**
+ * \file
+ * unittest/multilevel_layout.cpp: test cases for the coarsening hierarchy of the multi-level layout.
+ */
+
+#include "catch.hpp"
+
+#include <cmath>
+#include <handlegraph/util.hpp>
+#include "odgi.hpp"
+#include "algorithms/multilevel_layout.hpp"
+
+namespace odgi {
+	namespace unittest {
+
+		using namespace std;
+		using namespace handlegraph;
+		using namespace algorithms;
+
+		TEST_CASE("Coarsening merges the nodes that the paths traverse one after the other.", "[multilevel]") {
+
+			graph_t graph;
+			std::vector<handle_t> handles;
+			for (auto& seq : {"A", "CC", "G", "TT", "A", "C"}) {
+				handles.push_back(graph.create_handle(seq));
+			}
+			path_handle_t path = graph.create_path_handle("x");
+			for (uint64_t i = 0; i < handles.size(); ++i) {
+				if (i > 0) {
+					graph.create_edge(handles[i - 1], handles[i]);
+				}
+				graph.append_step(path, handles[i]);
+			}
+			const std::vector<path_handle_t> paths = {path};
+
+			SECTION("The finest level follows the graph.") {
+				layout_level_t level = graph_layout_level(graph, paths, 2);
+				REQUIRE(level.n_nodes == 6);
+				REQUIRE(level.length == std::vector<uint64_t>({1, 2, 1, 2, 1, 1}));
+				REQUIRE(level.steps == std::vector<uint64_t>({0, 1, 2, 3, 4, 5}));
+				REQUIRE(level.end == std::vector<uint64_t>({1, 3, 4, 6, 7, 8}));
+			}
+
+			SECTION("Neighboring nodes are matched in node order, and their steps merged.") {
+				layout_level_t fine = graph_layout_level(graph, paths, 2);
+				layout_level_t coarse = coarsen_layout_level(fine, 2);
+				REQUIRE(fine.parent == std::vector<uint64_t>({0, 0, 1, 1, 2, 2}));
+				REQUIRE(coarse.n_nodes == 3);
+				REQUIRE(coarse.length == std::vector<uint64_t>({3, 3, 2}));
+				REQUIRE(coarse.path_offsets == std::vector<uint64_t>({0, 3}));
+				REQUIRE(coarse.steps == std::vector<uint64_t>({0, 1, 2}));
+				REQUIRE(coarse.begin == std::vector<uint64_t>({0, 3, 6}));
+				REQUIRE(coarse.end == std::vector<uint64_t>({3, 6, 8}));
+			}
+
+			SECTION("The layout is only moved when the graph can be coarsened.") {
+				std::vector<std::atomic<double>> X(12), Y(12);
+				for (uint64_t i = 0; i < 12; ++i) {
+					X[i].store(i);
+					Y[i].store(0);
+				}
+				REQUIRE(multilevel_path_sgd_layout(graph, paths, 6, 10, 0.01, false, 2, false, X, Y) == 0);
+				REQUIRE(X[5].load() == 5);
+
+				REQUIRE(multilevel_path_sgd_layout(graph, paths, 1, 10, 0.01, true, 2, false, X, Y) > 0);
+				for (uint64_t i = 0; i < 12; ++i) {
+					REQUIRE(std::isfinite(X[i].load()));
+					REQUIRE(std::isfinite(Y[i].load()));
+				}
+			}
+		}
+	}
+}
@@ -301,5 +301,109 @@ TEST_CASE("Graph simplification reduces a graph with a self inverting -/+ loop w
 
 }
 
+TEST_CASE("Graph simplification merges many runs at once in parallel", "[simplify]") {
+    graph_t graph;
+    handle_t a1 = graph.create_handle("GAT");
+    handle_t a2 = graph.create_handle("TAC");
+    handle_t a3 = graph.create_handle("A");
+    handle_t b = graph.create_handle("C");
+    handle_t d = graph.create_handle("G");
+    handle_t e1 = graph.create_handle("TT");
+    handle_t e2 = graph.create_handle("GG");
+    graph.create_edge(a1, a2);
+    graph.create_edge(a2, a3);
+    graph.create_edge(a3, b);
+    graph.create_edge(a3, d);
+    graph.create_edge(b, e1);
+    graph.create_edge(d, e1);
+    graph.create_edge(e1, e2);
+    path_handle_t p = graph.create_path_handle("p");
+    for (auto& h : { a1, a2, a3, b, e1, e2 }) {
+        graph.append_step(p, h);
+    }
+    path_handle_t q = graph.create_path_handle("q");
+    for (auto& h : { e2, e1, d, a3, a2, a1 }) {
+        graph.append_step(q, graph.flip(h));
+    }
+
+    const bool ok = algorithms::unchop(graph, 2, false);
+
+    SECTION("The graph is as expected") {
+        REQUIRE(ok);
+        REQUIRE(graph.get_node_count() == 4);
+        REQUIRE(graph.get_edge_count() == 4);
+        std::vector<std::string> seqs;
+        graph.for_each_handle([&](const handle_t& h) {
+            seqs.push_back(graph.get_sequence(h));
+        });
+        // the merged nodes keep the place of their runs in the order
+        REQUIRE(seqs == std::vector<std::string>({"GATTACA", "C", "G", "TTGG"}));
+    }
+
+    SECTION("The paths walk the merged nodes along the edges") {
+        for (auto& path : { p, q }) {
+            REQUIRE(graph.get_step_count(path) == 4);
+            step_handle_t step = graph.path_begin(path);
+            while (graph.has_next_step(step)) {
+                step_handle_t next = graph.get_next_step(step);
+                REQUIRE(graph.has_edge(graph.get_handle_of_step(step), graph.get_handle_of_step(next)));
+                step = next;
+            }
+        }
+        REQUIRE(graph.get_sequence(graph.get_handle_of_step(graph.path_begin(q))) == "CCAA");
+        REQUIRE(graph.get_sequence(graph.get_handle_of_step(graph.path_back(q))) == "TGTAATC");
+    }
+}
+
+TEST_CASE("Graph simplification leaves runs that a circular path wraps inside", "[simplify]") {
+    graph_t graph;
+    handle_t n1 = graph.create_handle("A");
+    handle_t n2 = graph.create_handle("CC");
+    handle_t n3 = graph.create_handle("GGG");
+    graph.create_edge(n1, n2);
+    graph.create_edge(n2, n3);
+    graph.create_edge(n3, n1);
+    // the path starts on n2 and ends on n1, inside the cycle
+    path_handle_t p = graph.create_path_handle("p", true);
+    for (auto& h : { n2, n3, n1 }) {
+        graph.append_step(p, h);
+    }
+    auto path_sequence = [&](void) {
+        std::string seq;
+        graph.for_each_step_in_path(p, [&](const step_handle_t& step) {
+            seq += graph.get_sequence(graph.get_handle_of_step(step));
+        });
+        return seq;
+    };
+
+    SECTION("A run with the path's ends inside is not merged") {
+        auto merged = graph.combine_handle_runs({ { n3, n1, n2 } });
+        REQUIRE(merged.size() == 1);
+        REQUIRE(merged[0] == std::vector<handle_t>({ n3, n1, n2 }));
+        REQUIRE(graph.get_node_count() == 3);
+        REQUIRE(graph.get_edge_count() == 3);
+        REQUIRE(graph.get_step_count(p) == 3);
+        REQUIRE(path_sequence() == "CCGGGA");
+    }
+
+    SECTION("A run with the path's ends at its ends is merged") {
+        auto merged = graph.combine_handle_runs({ { n2, n3 } });
+        REQUIRE(merged.size() == 1);
+        REQUIRE(merged[0].size() == 1);
+        REQUIRE(graph.get_sequence(merged[0][0]) == "CCGGG");
+        REQUIRE(graph.get_node_count() == 2);
+        REQUIRE(graph.get_edge_count() == 2);
+        REQUIRE(graph.get_step_count(p) == 2);
+        REQUIRE(path_sequence() == "CCGGGA");
+        REQUIRE(graph.get_is_circular(p));
+    }
+
+    SECTION("Unchop keeps the path") {
+        REQUIRE(algorithms::unchop(graph));
+        REQUIRE(path_sequence() == "CCGGGA");
+        REQUIRE(graph.get_is_circular(p));
+    }
+}
+
 }
 }
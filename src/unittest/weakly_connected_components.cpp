@@ -0,0 +1,71 @@
+/**
+ * \file
+ * unittest/weakly_connected_components.cpp: test cases for the implementation of the weakly connected components.
+ */
+
+#include "catch.hpp"
+
+#include <handlegraph/util.hpp>
+#include "odgi.hpp"
+#include "algorithms/weakly_connected_components.hpp"
+
+namespace odgi {
+	namespace unittest {
+
+		using namespace std;
+		using namespace handlegraph;
+		using namespace algorithms;
+
+		TEST_CASE("Weakly connected components are found through edges of any orientation.", "[wcc]") {
+
+			graph_t graph;
+			handle_t n1 = graph.create_handle("A");
+			handle_t n2 = graph.create_handle("C");
+			handle_t n3 = graph.create_handle("G");
+			handle_t n4 = graph.create_handle("T");
+			handle_t n5 = graph.create_handle("A");
+			handle_t n6 = graph.create_handle("C");
+			// component 0: 1+ -> 3-, 3- -> 2+ (left side of 2 to left side of 3)
+			graph.create_edge(n1, graph.flip(n3));
+			graph.create_edge(graph.flip(n2), n3);
+			// component 1: 4 alone
+			// component 2: 5, 6 joined through the left sides
+			graph.create_edge(graph.flip(n6), n5);
+
+			auto check_ids = [&](const uint64_t& nthreads) {
+				uint64_t n_components = 0;
+				std::vector<uint64_t> component_ids = weakly_connected_component_ids(graph, n_components, nthreads);
+				REQUIRE(n_components == 3);
+				REQUIRE(component_ids == std::vector<uint64_t>({0, 0, 0, 1, 2, 2}));
+
+				std::vector<nid_t> members;
+				std::vector<uint64_t> offsets;
+				weakly_connected_component_members(graph, component_ids, n_components, members, offsets);
+				REQUIRE(offsets == std::vector<uint64_t>({0, 3, 4, 6}));
+				REQUIRE(members == std::vector<nid_t>({1, 2, 3, 4, 5, 6}));
+			};
+
+			SECTION("The component ids are compact and ordered by the smallest node id.") {
+				check_ids(1);
+			}
+
+			SECTION("The parallel sweep finds the same components.") {
+				check_ids(4);
+			}
+
+			SECTION("The set and handle vector interfaces agree with the component ids.") {
+				auto components = weakly_connected_components(&graph, 2);
+				REQUIRE(components.size() == 3);
+				REQUIRE(components[0].size() == 3);
+				REQUIRE(components[0].count(2));
+				REQUIRE(components[1].size() == 1);
+				REQUIRE(components[1].count(4));
+				REQUIRE(components[2].size() == 2);
+
+				auto vectors = weakly_connected_component_vectors(&graph, 2);
+				REQUIRE(vectors.size() == 3);
+				REQUIRE(vectors[2] == std::vector<handle_t>({n5, n6}));
+			}
+		}
+	}
+}
@@ -1,6 +1,7 @@
 #include <string>
 #include <algorithm>
 #include "utils.hpp"
+#include "algorithms/instrumentation.hpp"
 
 namespace utils {
     bool is_number(const std::string &s) {
@@ -66,6 +67,7 @@ namespace utils {
 			std::cerr << "[odgi::" << subcommmand_name << "] error: the given file \"" << infile << "\" does not exist. Please specify an existing input file in ODGI format via -i=[FILE], --idx=[FILE]." << std::endl;
 			exit(1);
 		}
+		odgi::algorithms::instrumentation::Phase phase("load");
 		if (utils::ends_with(infile, "gfa")) {
 			if (progress) {
 				std::cerr << "[odgi::" << subcommmand_name << "] warning: the given file \"" << infile << "\" is not in ODGI format. "
@@ -79,6 +81,7 @@ namespace utils {
 			graph.deserialize(f);
 			f.close();
 		}
+		phase.add_items(graph.get_node_count());
 		return 0;
     }
 